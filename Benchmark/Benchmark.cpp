@@ -0,0 +1,376 @@
+///////////////////////////////////////////////////////////////////////////////
+/// GlFrameworkBasic is free software : you can redistribute it and or modify
+/// it under the terms of the GNU General Public License as published by
+/// the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// GlFrameworkBasic is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with GlFrameworkBasic. If not, see <http://www.gnu.org/licenses/>.
+///
+/// Author: Evan Edstrom
+/// Date: 11/17/2013
+/// Website: http://evanedstrom.com/glstart
+/// Email: contact@evanedstrom.com
+///
+///////////////////////////////////////////////////////////////////////////////
+
+
+// Scalability benchmark. Runs the Engine headless over synthetic scenes of
+// Elements and Circles and reports per-element update and draw cost, frame
+// time percentiles and peak memory as JSON. Pass --baseline with an earlier
+// JSON file to flag regressions; the exit code is 1 when any are found.
+// Draw costs need an offscreen GL provider (GLFRAMEWORK_HEADLESS_OSMESA or
+// GLFRAMEWORK_HEADLESS_EGL); without one scenes report "gl": false and a
+// null draw cost.
+//
+// Usage: Benchmark [--max N] [--frames F] [--filter text] [--no-batch] [--type-sorted]
+//                  [--draw-sorted] [--instanced] [--out file.json] [--baseline file.json] [--tolerance 0.10]
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Engine.h"
+#include "TestCircle.h"
+
+using namespace glFrameworkBasic;
+
+namespace {
+	enum SceneType { SCENE_ELEMENTS, SCENE_CIRCLES, SCENE_MIXED, SCENE_PARTICLES };
+
+	struct Scene {
+		SceneType type;
+		bool moving;
+		unsigned int count;
+		std::string name;
+	};
+
+	struct Result {
+		Scene scene;
+		double updateNs, drawNs;		// Per element, averaged over measured frames
+		double frameP50, frameP90, frameP99, frameMax;	// Milliseconds
+		double peakRssMb;			// Highest resident set sampled during this scene
+		bool gl;					// Frames were drawn by a GL context
+	};
+
+	/// <summary>Engine settings under test, from the command line.</summary>
+	struct Options {
+		bool batch;
+		bool typeSorted;
+		bool drawSorted;
+		bool instanced;
+	};
+
+	const unsigned int WARMUP_FRAMES = 3;
+
+	/// <summary>
+	/// Current resident set in megabytes. The process-wide peak cannot be
+	/// reset between scenes, so scenes sample this once per frame instead.
+	/// </summary>
+	double residentMb(){
+#if defined(_WIN32)
+		PROCESS_MEMORY_COUNTERS counters;
+		if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return 0.0;
+		return counters.WorkingSetSize / (1024.0 * 1024.0);
+#else
+		long pages = 0, resident = 0;
+		FILE *statm = fopen("/proc/self/statm", "r");
+		if (statm == NULL) return 0.0;
+		const bool ok = fscanf(statm, "%ld %ld", &pages, &resident) == 2;
+		fclose(statm);
+		return ok ? resident * (double)sysconf(_SC_PAGESIZE) / (1024.0 * 1024.0) : 0.0;
+#endif
+	}
+
+	double percentile(std::vector<double> sorted, double p){
+		if (sorted.empty()) return 0.0;
+		std::sort(sorted.begin(), sorted.end());
+		return sorted[(size_t)(p * (sorted.size() - 1) + 0.5)];
+	}
+
+	/**
+	* Engine that fills itself with one scene and records frame times.
+	* Profiling starts after a few warm-up frames so pools, batches and
+	* caches have reached their working size.
+	*/
+	class BenchmarkEngine : public Engine
+	{
+	public:
+		std::vector<double> frameMs;
+		double peakRssMb;
+
+		BenchmarkEngine(const Scene &s, const Options &options) : peakRssMb(0.0), scene(s), lastFrame(0.0)
+		{
+			SetBackend(BACKEND_HEADLESS);
+			SetBatching(options.batch);
+			SetTypeSorted(options.typeSorted);
+			SetDrawSorting(options.drawSorted);
+			SetInstancing(options.instanced);
+			SetCulling(false);	// Measure the full draw cost
+		}
+
+	protected:
+		void setup()
+		{
+			srand(12345);	// Same scene every run
+			if (scene.type == SCENE_PARTICLES) {
+				// One long-lived burst, so the count holds through the run.
+				ParticleEmitter emitter;
+				emitter.rate = 0.0f;
+				emitter.lifeMin = emitter.lifeMax = 1000.0f;
+				emitter.speedMin = scene.moving ? 1.0f : 0.0f;
+				emitter.speedMax = scene.moving ? 20.0f : 0.0f;
+				emitter.startColor[0] = 1.0f; emitter.startColor[1] = 0.5f; emitter.startColor[2] = 0.0f;
+				emitter.startSize = emitter.endSize = 0.5f;
+				particles.SetSeed(12345);
+				particles.Reserve(scene.count);
+				particles.Emit(particles.AddEmitter(emitter), scene.count);
+				return;
+			}
+			Pool<Element>().Reserve(scene.type == SCENE_CIRCLES ? 0 : scene.count);
+			Pool<Circle>().Reserve(scene.type == SCENE_ELEMENTS ? 0 : scene.count);
+			for (unsigned int i = 0; i < scene.count; i++) {
+				bool circle = scene.type == SCENE_CIRCLES || (scene.type == SCENE_MIXED && (i & 1));
+				Element *e = circle ? (Element *)Get<Circle>(Spawn<Circle>()) : Get(Spawn<Element>());
+				e->SetPosition(random(-85.0f, 85.0f), random(-85.0f, 85.0f));
+				e->SetScale(random(1.0f, 4.0f));
+				if (scene.moving) e->SetVelocity(random(-1.0f, 1.0f), random(-1.0f, 1.0f));
+			}
+		}
+
+		void preDisplayLoop()
+		{
+			const double now = clock.Seconds();
+			if (GetFrameCount() > WARMUP_FRAMES) frameMs.push_back((now - lastFrame) * 1000.0);
+			if (GetFrameCount() == WARMUP_FRAMES) GetProfiler().SetEnabled(true);
+			peakRssMb = std::max(peakRssMb, residentMb());
+			lastFrame = clock.Seconds();	// Sampling is not part of the next frame
+		}
+
+	private:
+		Scene scene;
+		Clock clock;
+		double lastFrame;
+
+		static float random(float low, float high)
+		{
+			return low + (high - low) * (rand() / (float)RAND_MAX);
+		}
+	};
+
+	Result runScene(const Scene &scene, unsigned int frames, const Options &options){
+		Result result;
+		result.scene = scene;
+
+		BenchmarkEngine engine(scene, options);
+		// One extra frame so the last measured frame is closed by preDisplayLoop.
+		engine.SetFrameLimit(WARMUP_FRAMES + frames + 1);
+		char name[] = "Benchmark";
+		char *argv[] = { name, NULL };
+		engine.Begin(1, argv);
+
+		std::vector<ProfileSummary> summaries;
+		engine.GetProfiler().Summarize(summaries);
+		result.updateNs = result.drawNs = 0.0;
+		for (size_t i = 0; i < summaries.size(); i++) {
+			const double nsPerElement = summaries[i].avgMs * 1.0e6 / scene.count;
+			if (strcmp(summaries[i].name, "update") == 0 || strcmp(summaries[i].name, "particles") == 0)
+				result.updateNs += nsPerElement;
+			else if (strcmp(summaries[i].name, "draw") == 0) result.drawNs = nsPerElement;
+		}
+
+		result.frameP50 = percentile(engine.frameMs, 0.50);
+		result.frameP90 = percentile(engine.frameMs, 0.90);
+		result.frameP99 = percentile(engine.frameMs, 0.99);
+		result.frameMax = percentile(engine.frameMs, 1.0);
+		result.peakRssMb = engine.peakRssMb;
+		result.gl = engine.HasGLContext();
+		return result;
+	}
+
+	void writeJson(std::ostream &out, const std::vector<Result> &results, unsigned int frames, const Options &options){
+		out << "{\n  \"benchmark\": \"GlutFrameworkObject\",\n";
+		out << "  \"frames\": " << frames << ",\n";
+		out << "  \"batching\": " << (options.batch ? "true" : "false") << ",\n";
+		out << "  \"type_sorted\": " << (options.typeSorted ? "true" : "false") << ",\n";
+		out << "  \"draw_sorted\": " << (options.drawSorted ? "true" : "false") << ",\n";
+		out << "  \"instanced\": " << (options.instanced ? "true" : "false") << ",\n";
+		out << "  \"scenes\": [\n";
+		for (size_t i = 0; i < results.size(); i++) {
+			const Result &r = results[i];
+			// One scene per line, readBaseline() depends on it.
+			out << "    {\"scene\": \"" << r.scene.name << "\", \"count\": " << r.scene.count
+				<< ", \"gl\": " << (r.gl ? "true" : "false")
+				<< ", \"update_ns_per_element\": " << r.updateNs
+				<< ", \"draw_ns_per_element\": ";
+			if (r.gl) out << r.drawNs;
+			else out << "null";	// GL calls were dropped, nothing was drawn
+			out << ", \"frame_ms_p50\": " << r.frameP50
+				<< ", \"frame_ms_p90\": " << r.frameP90
+				<< ", \"frame_ms_p99\": " << r.frameP99
+				<< ", \"frame_ms_max\": " << r.frameMax
+				<< ", \"peak_rss_mb\": " << r.peakRssMb << "}"
+				<< (i + 1 < results.size() ? ",\n" : "\n");
+		}
+		out << "  ]\n}\n";
+	}
+
+	/// <summary>Numeric field of a one-line scene object, or -1 when missing.</summary>
+	double jsonNumber(const std::string &line, const char *key){
+		const std::string quoted = std::string("\"") + key + "\":";
+		size_t at = line.find(quoted);
+		if (at == std::string::npos) return -1.0;
+		return atof(line.c_str() + at + quoted.size());
+	}
+
+	/// <summary>Reads the scenes of a file written by writeJson(), keyed by scene name.</summary>
+	bool readBaseline(const std::string &path, std::map<std::string, std::string> &scenes){
+		std::ifstream file(path.c_str());
+		if (!file) return false;
+		std::string line;
+		while (std::getline(file, line)) {
+			size_t at = line.find("\"scene\": \"");
+			if (at == std::string::npos) continue;
+			at += 10;
+			scenes[line.substr(at, line.find('"', at) - at)] = line;
+		}
+		return true;
+	}
+
+	/// <summary>
+	/// Compares update, draw and median frame time against the baseline.
+	/// A metric regresses when it is more than tolerance slower and the
+	/// difference in frame time is above timer noise. Returns the count.
+	/// </summary>
+	int compareBaseline(const std::vector<Result> &results, const std::map<std::string, std::string> &baseline, double tolerance){
+		const double noiseMs = 0.05;
+		int regressions = 0;
+		for (size_t i = 0; i < results.size(); i++) {
+			const Result &r = results[i];
+			std::map<std::string, std::string>::const_iterator found = baseline.find(r.scene.name);
+			if (found == baseline.end()) continue;
+
+			const char *keys[] = { "update_ns_per_element", "draw_ns_per_element", "frame_ms_p50" };
+			const double values[] = { r.updateNs, r.drawNs, r.frameP50 };
+			const double toMs[] = { r.scene.count / 1.0e6, r.scene.count / 1.0e6, 1.0 };
+			for (int k = 0; k < 3; k++) {
+				if (k == 1 && !r.gl) continue;	// No draw cost without a context
+				const double before = jsonNumber(found->second, keys[k]);
+				if (before <= 0.0) continue;
+				if (values[k] > before * (1.0 + tolerance) && (values[k] - before) * toMs[k] > noiseMs) {
+					std::cerr << "REGRESSION " << r.scene.name << " " << keys[k] << ": "
+						<< before << " -> " << values[k] << " (+"
+						<< (int)((values[k] / before - 1.0) * 100.0 + 0.5) << "%)\n";
+					regressions++;
+				}
+			}
+		}
+		return regressions;
+	}
+}
+
+int main(int argc, char **argv){
+	unsigned int maxCount = 1000000;
+	unsigned int frames = 30;
+	Options options;
+	options.batch = true;
+	options.typeSorted = false;
+	options.drawSorted = false;
+	options.instanced = false;
+	double tolerance = 0.10;
+	std::string filter, outPath, baselinePath;
+
+	for (int i = 1; i < argc; i++) {
+		const bool hasValue = i + 1 < argc;
+		if (strcmp(argv[i], "--max") == 0 && hasValue) maxCount = (unsigned int)atol(argv[++i]);
+		else if (strcmp(argv[i], "--frames") == 0 && hasValue) frames = (unsigned int)atol(argv[++i]);
+		else if (strcmp(argv[i], "--filter") == 0 && hasValue) filter = argv[++i];
+		else if (strcmp(argv[i], "--out") == 0 && hasValue) outPath = argv[++i];
+		else if (strcmp(argv[i], "--baseline") == 0 && hasValue) baselinePath = argv[++i];
+		else if (strcmp(argv[i], "--tolerance") == 0 && hasValue) tolerance = atof(argv[++i]);
+		else if (strcmp(argv[i], "--no-batch") == 0) options.batch = false;
+		else if (strcmp(argv[i], "--type-sorted") == 0) options.typeSorted = true;
+		else if (strcmp(argv[i], "--draw-sorted") == 0) options.drawSorted = true;
+		else if (strcmp(argv[i], "--instanced") == 0) options.instanced = true;
+		else {
+			std::cerr << "Usage: Benchmark [--max N] [--frames F] [--filter text] [--no-batch] [--type-sorted]\n"
+				"                 [--draw-sorted] [--instanced] [--out file.json] [--baseline file.json] [--tolerance 0.10]\n";
+			return 2;
+		}
+	}
+	if (frames < 1) frames = 1;
+
+	// Every type, moving and static, at each power of ten up to maxCount.
+	const char *typeNames[] = { "elements", "circles", "mixed", "particles" };
+	std::vector<Scene> scenes;
+	for (unsigned int count = 1; count <= maxCount; count *= 10) {
+		for (int type = 0; type < 4; type++) {
+			for (int moving = 1; moving >= 0; moving--) {
+				Scene scene;
+				scene.type = (SceneType)type;
+				scene.moving = moving != 0;
+				scene.count = count;
+				std::ostringstream name;
+				name << typeNames[type] << (moving ? "_moving_" : "_static_") << count;
+				scene.name = name.str();
+				if (filter.empty() || scene.name.find(filter) != std::string::npos)
+					scenes.push_back(scene);
+			}
+		}
+		if (count > maxCount / 10) break;	// Avoid overflow past 1M
+	}
+
+	std::vector<Result> results;
+	for (size_t i = 0; i < scenes.size(); i++) {
+		Result r = runScene(scenes[i], frames, options);
+		results.push_back(r);
+		if (i == 0 && !r.gl)
+			std::cerr << "No offscreen GL context: draw costs are not measured (build with GLFRAMEWORK_HEADLESS_OSMESA or GLFRAMEWORK_HEADLESS_EGL)\n";
+		fprintf(stderr, "%-24s update %8.2f ns/el  ", r.scene.name.c_str(), r.updateNs);
+		if (r.gl) fprintf(stderr, "draw %8.2f ns/el  ", r.drawNs);
+		else fprintf(stderr, "draw %8s ns/el  ", "n/a");	// Not measured
+		fprintf(stderr, "frame p50 %8.3f p99 %8.3f ms  rss %7.1f MB\n", r.frameP50, r.frameP99, r.peakRssMb);
+	}
+
+	if (outPath.empty()) writeJson(std::cout, results, frames, options);
+	else {
+		std::ofstream out(outPath.c_str());
+		if (!out) {
+			std::cerr << "Cannot write " << outPath << "\n";
+			return 2;
+		}
+		writeJson(out, results, frames, options);
+	}
+
+	if (!baselinePath.empty()) {
+		std::map<std::string, std::string> baseline;
+		if (!readBaseline(baselinePath, baseline)) {
+			std::cerr << "Cannot read baseline " << baselinePath << "\n";
+			return 2;
+		}
+		const int regressions = compareBaseline(results, baseline, tolerance);
+		std::cerr << regressions << " regression(s) against " << baselinePath << "\n";
+		if (regressions > 0) return 1;
+	}
+	return 0;
+}
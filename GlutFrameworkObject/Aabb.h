@@ -0,0 +1,84 @@
+///////////////////////////////////////////////////////////////////////////////
+/// GlFrameworkBasic is free software : you can redistribute it and or modify
+/// it under the terms of the GNU General Public License as published by
+/// the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// GlFrameworkBasic is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with GlFrameworkBasic. If not, see <http://www.gnu.org/licenses/>.
+///
+/// Author: Evan Edstrom
+/// Date: 11/17/2013
+/// Website: http://evanedstrom.com/glstart
+/// Email: contact@evanedstrom.com
+///
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <cmath>
+
+#include "Transform.h"
+
+namespace glFrameworkBasic {
+	/// <summary>Axis aligned bounding box in world units (x, y only).</summary>
+	struct Aabb
+	{
+		float minX, minY, maxX, maxY;
+
+		Aabb() : minX(0.0f), minY(0.0f), maxX(0.0f), maxY(0.0f) {}
+		Aabb(float x0, float y0, float x1, float y1) : minX(x0), minY(y0), maxX(x1), maxY(y1) {}
+
+		/// <summary>Box around a local rectangle of half size hx, hy mapped by t.</summary>
+		static Aabb FromTransform(const Transform &t, float hx, float hy)
+		{
+			const float ex = fabs(t.a) * hx + fabs(t.c) * hy;
+			const float ey = fabs(t.b) * hx + fabs(t.d) * hy;
+			return Aabb(t.tx - ex, t.ty - ey, t.tx + ex, t.ty + ey);
+		}
+
+		bool Overlaps(const Aabb &o) const
+		{
+			return minX <= o.maxX && o.minX <= maxX && minY <= o.maxY && o.minY <= maxY;
+		}
+
+		bool Contains(const Aabb &o) const
+		{
+			return minX <= o.minX && minY <= o.minY && o.maxX <= maxX && o.maxY <= maxY;
+		}
+
+		/// <summary>Smallest box holding both.</summary>
+		Aabb Union(const Aabb &o) const
+		{
+			return Aabb(minX < o.minX ? minX : o.minX, minY < o.minY ? minY : o.minY,
+				maxX > o.maxX ? maxX : o.maxX, maxY > o.maxY ? maxY : o.maxY);
+		}
+
+		/// <summary>Box around this box mapped by t, such as from parent to world space.</summary>
+		Aabb Transformed(const Transform &t) const
+		{
+			const float hx = 0.5f * (maxX - minX), hy = 0.5f * (maxY - minY);
+			const float cx = minX + hx, cy = minY + hy;
+			const float ex = fabs(t.a) * hx + fabs(t.c) * hy;
+			const float ey = fabs(t.b) * hx + fabs(t.d) * hy;
+			const float x = t.X(cx, cy), y = t.Y(cx, cy);
+			return Aabb(x - ex, y - ey, x + ex, y + ey);
+		}
+
+		/// <summary>Box grown by margin on every side.</summary>
+		Aabb Expanded(float margin) const
+		{
+			return Aabb(minX - margin, minY - margin, maxX + margin, maxY + margin);
+		}
+
+		/// <summary>Perimeter, the cost measure used by the AABB tree.</summary>
+		float Perimeter() const
+		{
+			return 2.0f * ((maxX - minX) + (maxY - minY));
+		}
+	};
+}
@@ -0,0 +1,294 @@
+///////////////////////////////////////////////////////////////////////////////
+/// GlFrameworkBasic is free software : you can redistribute it and or modify
+/// it under the terms of the GNU General Public License as published by
+/// the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// GlFrameworkBasic is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with GlFrameworkBasic. If not, see <http://www.gnu.org/licenses/>.
+///
+/// Author: Evan Edstrom
+/// Date: 11/17/2013
+/// Website: http://evanedstrom.com/glstart
+/// Email: contact@evanedstrom.com
+///
+///////////////////////////////////////////////////////////////////////////////
+
+#include "AabbTreeBroadphase.h"
+
+namespace glFrameworkBasic {
+	AabbTreeBroadphase::AabbTreeBroadphase(float fatMargin)
+	{
+		margin = fatMargin > 0.0f ? fatMargin : 0.0f;
+		root = NULL_NODE;
+		freeList = NULL_NODE;
+		stamp = 0;
+	}
+
+	void AabbTreeBroadphase::Update(const std::vector<Element *> &elements){
+		stamp++;
+		for (size_t i = 0; i < elements.size(); i++) {
+			Element *element = elements[i];
+			const Aabb box = element->GetWorldBounds();
+
+			std::unordered_map<Element *, int>::iterator found = proxies.find(element);
+			if (found == proxies.end()) {
+				const int leaf = allocateNode();
+				nodes[leaf].element = element;
+				nodes[leaf].tight = box;
+				nodes[leaf].box = box.Expanded(margin);
+				nodes[leaf].stamp = stamp;
+				insertLeaf(leaf);
+				proxies[element] = leaf;
+				continue;
+			}
+
+			const int leaf = found->second;
+			nodes[leaf].tight = box;
+			nodes[leaf].stamp = stamp;
+			if (!nodes[leaf].box.Contains(box)) {
+				// Left its fat box, re-insert with a fresh one.
+				removeLeaf(leaf);
+				nodes[leaf].box = box.Expanded(margin);
+				insertLeaf(leaf);
+			}
+		}
+
+		// Only sweep for removed elements when some must be missing.
+		if (proxies.size() > elements.size()) {
+			for (std::unordered_map<Element *, int>::iterator i = proxies.begin(); i != proxies.end();) {
+				if (nodes[i->second].stamp != stamp) {
+					removeLeaf(i->second);
+					freeNode(i->second);
+					i = proxies.erase(i);
+				}
+				else ++i;
+			}
+		}
+	}
+
+	void AabbTreeBroadphase::FindPairs(std::vector<ElementPair> &pairs){
+		pairs.clear();
+		if (root == NULL_NODE) return;
+
+		// Walk the tree against itself. An entry (a, a) means "pairs inside
+		// subtree a", (a, b) means "pairs between subtrees a and b". Each
+		// pair of leaves is reached exactly once, and whole subtrees are
+		// skipped as soon as their boxes stop overlapping.
+		stack.clear();
+		stack.push_back(root);
+		stack.push_back(root);
+		while (!stack.empty()) {
+			const int b = stack.back(); stack.pop_back();
+			const int a = stack.back(); stack.pop_back();
+
+			if (a == b) {
+				if (isLeaf(a)) continue;
+				const int left = nodes[a].left, right = nodes[a].right;
+				stack.push_back(left); stack.push_back(left);
+				stack.push_back(right); stack.push_back(right);
+				stack.push_back(left); stack.push_back(right);
+				continue;
+			}
+
+			const Node &na = nodes[a], &nb = nodes[b];
+			if (!na.box.Overlaps(nb.box)) continue;
+
+			const bool leafA = na.left == NULL_NODE, leafB = nb.left == NULL_NODE;
+			if (leafA && leafB) {
+				if (na.tight.Overlaps(nb.tight)) {
+					ElementPair p = { na.element, nb.element };
+					pairs.push_back(p);
+				}
+			}
+			else if (leafB || (!leafA && na.height >= nb.height)) {
+				// Descend the bigger subtree.
+				const int left = na.left, right = na.right;
+				stack.push_back(left); stack.push_back(b);
+				stack.push_back(right); stack.push_back(b);
+			}
+			else {
+				const int left = nb.left, right = nb.right;
+				stack.push_back(a); stack.push_back(left);
+				stack.push_back(a); stack.push_back(right);
+			}
+		}
+	}
+
+	int AabbTreeBroadphase::Height() const {
+		return root == NULL_NODE ? -1 : nodes[root].height;
+	}
+
+	int AabbTreeBroadphase::allocateNode(){
+		int index;
+		if (freeList != NULL_NODE) {
+			index = freeList;
+			freeList = nodes[index].parent;
+		}
+		else {
+			index = (int)nodes.size();
+			nodes.push_back(Node());
+		}
+		Node &node = nodes[index];
+		node.element = NULL;
+		node.parent = NULL_NODE;
+		node.left = NULL_NODE;
+		node.right = NULL_NODE;
+		node.height = 0;
+		node.stamp = 0;
+		return index;
+	}
+
+	void AabbTreeBroadphase::freeNode(int index){
+		nodes[index].parent = freeList;
+		nodes[index].height = -1;
+		nodes[index].element = NULL;
+		freeList = index;
+	}
+
+	void AabbTreeBroadphase::insertLeaf(int leaf){
+		if (root == NULL_NODE) {
+			root = leaf;
+			nodes[root].parent = NULL_NODE;
+			return;
+		}
+
+		// Walk down to the sibling whose box grows the least.
+		const Aabb leafBox = nodes[leaf].box;
+		int index = root;
+		while (!isLeaf(index)) {
+			const int left = nodes[index].left, right = nodes[index].right;
+			const float area = nodes[index].box.Perimeter();
+			const float combinedArea = nodes[index].box.Union(leafBox).Perimeter();
+
+			// Cost of making a new parent here, and the growth pushed to ancestors.
+			const float cost = 2.0f * combinedArea;
+			const float inheritance = 2.0f * (combinedArea - area);
+
+			float costLeft = leafBox.Union(nodes[left].box).Perimeter() + inheritance;
+			if (!isLeaf(left)) costLeft -= nodes[left].box.Perimeter();
+			float costRight = leafBox.Union(nodes[right].box).Perimeter() + inheritance;
+			if (!isLeaf(right)) costRight -= nodes[right].box.Perimeter();
+
+			if (cost < costLeft && cost < costRight) break;
+			index = costLeft < costRight ? left : right;
+		}
+
+		const int sibling = index;
+		const int oldParent = nodes[sibling].parent;
+		const int newParent = allocateNode();
+		nodes[newParent].parent = oldParent;
+		nodes[newParent].box = leafBox.Union(nodes[sibling].box);
+		nodes[newParent].height = nodes[sibling].height + 1;
+		nodes[newParent].left = sibling;
+		nodes[newParent].right = leaf;
+		nodes[sibling].parent = newParent;
+		nodes[leaf].parent = newParent;
+
+		if (oldParent == NULL_NODE) root = newParent;
+		else if (nodes[oldParent].left == sibling) nodes[oldParent].left = newParent;
+		else nodes[oldParent].right = newParent;
+
+		refitUpward(nodes[leaf].parent);
+	}
+
+	void AabbTreeBroadphase::removeLeaf(int leaf){
+		if (leaf == root) {
+			root = NULL_NODE;
+			return;
+		}
+
+		const int parent = nodes[leaf].parent;
+		const int grandParent = nodes[parent].parent;
+		const int sibling = nodes[parent].left == leaf ? nodes[parent].right : nodes[parent].left;
+
+		if (grandParent == NULL_NODE) {
+			root = sibling;
+			nodes[sibling].parent = NULL_NODE;
+			freeNode(parent);
+			return;
+		}
+
+		// Replace the parent with the sibling.
+		if (nodes[grandParent].left == parent) nodes[grandParent].left = sibling;
+		else nodes[grandParent].right = sibling;
+		nodes[sibling].parent = grandParent;
+		freeNode(parent);
+		refitUpward(grandParent);
+	}
+
+	void AabbTreeBroadphase::refitUpward(int index){
+		while (index != NULL_NODE) {
+			index = balance(index);
+			const int left = nodes[index].left, right = nodes[index].right;
+			const int hl = nodes[left].height, hr = nodes[right].height;
+			nodes[index].height = 1 + (hl > hr ? hl : hr);
+			nodes[index].box = nodes[left].box.Union(nodes[right].box);
+			index = nodes[index].parent;
+		}
+	}
+
+	int AabbTreeBroadphase::balance(int a){
+		if (isLeaf(a) || nodes[a].height < 2) return a;
+
+		const int b = nodes[a].left;
+		const int c = nodes[a].right;
+		const int diff = nodes[c].height - nodes[b].height;
+
+		if (diff > 1) {
+			// Rotate c up.
+			const int f = nodes[c].left;
+			const int g = nodes[c].right;
+			nodes[c].left = a;
+			nodes[c].parent = nodes[a].parent;
+			nodes[a].parent = c;
+			const int cp = nodes[c].parent;
+			if (cp == NULL_NODE) root = c;
+			else if (nodes[cp].left == a) nodes[cp].left = c;
+			else nodes[cp].right = c;
+
+			// Keep the taller grandchild under c.
+			const int keep = nodes[f].height > nodes[g].height ? f : g;
+			const int give = keep == f ? g : f;
+			nodes[c].right = keep;
+			nodes[a].right = give;
+			nodes[give].parent = a;
+			nodes[a].box = nodes[b].box.Union(nodes[give].box);
+			nodes[c].box = nodes[a].box.Union(nodes[keep].box);
+			nodes[a].height = 1 + (nodes[b].height > nodes[give].height ? nodes[b].height : nodes[give].height);
+			nodes[c].height = 1 + (nodes[a].height > nodes[keep].height ? nodes[a].height : nodes[keep].height);
+			return c;
+		}
+
+		if (diff < -1) {
+			// Rotate b up.
+			const int d = nodes[b].left;
+			const int e = nodes[b].right;
+			nodes[b].left = a;
+			nodes[b].parent = nodes[a].parent;
+			nodes[a].parent = b;
+			const int bp = nodes[b].parent;
+			if (bp == NULL_NODE) root = b;
+			else if (nodes[bp].left == a) nodes[bp].left = b;
+			else nodes[bp].right = b;
+
+			const int keep = nodes[d].height > nodes[e].height ? d : e;
+			const int give = keep == d ? e : d;
+			nodes[b].right = keep;
+			nodes[a].left = give;
+			nodes[give].parent = a;
+			nodes[a].box = nodes[c].box.Union(nodes[give].box);
+			nodes[b].box = nodes[a].box.Union(nodes[keep].box);
+			nodes[a].height = 1 + (nodes[c].height > nodes[give].height ? nodes[c].height : nodes[give].height);
+			nodes[b].height = 1 + (nodes[a].height > nodes[keep].height ? nodes[a].height : nodes[keep].height);
+			return b;
+		}
+
+		return a;
+	}
+}
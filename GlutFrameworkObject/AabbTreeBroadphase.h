@@ -0,0 +1,81 @@
+///////////////////////////////////////////////////////////////////////////////
+/// GlFrameworkBasic is free software : you can redistribute it and or modify
+/// it under the terms of the GNU General Public License as published by
+/// the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// GlFrameworkBasic is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with GlFrameworkBasic. If not, see <http://www.gnu.org/licenses/>.
+///
+/// Author: Evan Edstrom
+/// Date: 11/17/2013
+/// Website: http://evanedstrom.com/glstart
+/// Email: contact@evanedstrom.com
+///
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <unordered_map>
+#include <vector>
+
+#include "Aabb.h"
+#include "Broadphase.h"
+
+namespace glFrameworkBasic {
+	/**
+	* Dynamic AABB tree broadphase, best for elements of mixed sizes. Each
+	* element is a leaf holding a "fat" box grown by a margin; a leaf is only
+	* re-inserted when the element leaves its fat box, so small movements
+	* cost nothing. Inserts pick the sibling with the cheapest perimeter
+	* growth and tree rotations keep it balanced.
+	*/
+	class AabbTreeBroadphase : public Broadphase
+	{
+	public:
+		/// <summary>Creates an empty tree. margin is how far fat boxes reach past an element.</summary>
+		explicit AabbTreeBroadphase(float margin = 1.0f);
+
+		void Update(const std::vector<Element *> &elements);
+		void FindPairs(std::vector<ElementPair> &pairs);
+
+		/// <summary>Height of the tree, 0 for a single leaf, -1 when empty.</summary>
+		int Height() const;
+
+	private:
+		static const int NULL_NODE = -1;
+
+		struct Node {
+			Aabb box;			// Fat box for leaves, union of children otherwise
+			Aabb tight;			// Exact element bounds, leaves only
+			Element *element;	// NULL for inner nodes
+			int parent;			// Next free node while on the free list
+			int left, right;	// NULL_NODE for leaves
+			int height;			// 0 for leaves, -1 while free
+			unsigned int stamp;	// Update() pass that last saw this leaf
+		};
+
+		float margin;
+		std::vector<Node> nodes;
+		int root;
+		int freeList;
+		unsigned int stamp;
+		std::unordered_map<Element *, int> proxies;
+		std::vector<int> stack;		// Traversal scratch of node pairs, kept between frames
+
+		int allocateNode();
+		void freeNode(int index);
+		void insertLeaf(int leaf);
+		void removeLeaf(int leaf);
+		int balance(int index);
+
+		/// <summary>Refits boxes and heights from index up to the root, balancing on the way.</summary>
+		void refitUpward(int index);
+
+		bool isLeaf(int index) const { return nodes[index].left == NULL_NODE; }
+	};
+}
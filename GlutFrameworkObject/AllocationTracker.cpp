@@ -0,0 +1,275 @@
+///////////////////////////////////////////////////////////////////////////////
+/// GlFrameworkBasic is free software : you can redistribute it and or modify
+/// it under the terms of the GNU General Public License as published by
+/// the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// GlFrameworkBasic is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with GlFrameworkBasic. If not, see <http://www.gnu.org/licenses/>.
+///
+/// Author: Evan Edstrom
+/// Date: 11/17/2013
+/// Website: http://evanedstrom.com/glstart
+/// Email: contact@evanedstrom.com
+///
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include "AllocationTracker.h"
+#include "Platform.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+
+namespace glFrameworkBasic {
+	namespace {
+		GLFRAMEWORK_THREAD_LOCAL AllocationTracker *currentTracker = NULL;
+		GLFRAMEWORK_THREAD_LOCAL const char *currentPhase = NULL;
+
+		const char *const OTHER_PHASE = "other";
+
+		bool moreAllocations(const AllocationSite &a, const AllocationSite &b){
+			return a.allocations > b.allocations;
+		}
+
+		unsigned int hashSite(const void *address, const char *phase){
+			size_t h = (size_t)address ^ ((size_t)phase * 31u);
+			h ^= h >> 13;
+			h *= 0x9E3779B1u;
+			return (unsigned int)(h ^ (h >> 16));
+		}
+	}
+
+#if defined(GLFRAMEWORK_TRACK_ALLOCATIONS)
+	namespace {
+		GLFRAMEWORK_THREAD_LOCAL bool recording = false;	// Guards against re-entry from Record()
+
+		void recordAllocation(size_t bytes, const void *site){
+			AllocationTracker *tracker = currentTracker;
+			if (tracker == NULL || recording) return;
+			recording = true;
+			tracker->Record(bytes, site);
+			recording = false;
+		}
+
+		void *allocate(size_t bytes){
+			void *p = std::malloc(bytes == 0 ? 1 : bytes);
+			if (p == NULL) throw std::bad_alloc();
+			return p;
+		}
+	}
+}
+
+// Global replacements. Every form books its caller and forwards to malloc().
+void *operator new(size_t bytes){
+	glFrameworkBasic::recordAllocation(bytes, GLFRAMEWORK_RETURN_ADDRESS());
+	return glFrameworkBasic::allocate(bytes);
+}
+
+void *operator new[](size_t bytes){
+	glFrameworkBasic::recordAllocation(bytes, GLFRAMEWORK_RETURN_ADDRESS());
+	return glFrameworkBasic::allocate(bytes);
+}
+
+void *operator new(size_t bytes, const std::nothrow_t &) GLFRAMEWORK_NOEXCEPT{
+	glFrameworkBasic::recordAllocation(bytes, GLFRAMEWORK_RETURN_ADDRESS());
+	return std::malloc(bytes == 0 ? 1 : bytes);
+}
+
+void *operator new[](size_t bytes, const std::nothrow_t &) GLFRAMEWORK_NOEXCEPT{
+	glFrameworkBasic::recordAllocation(bytes, GLFRAMEWORK_RETURN_ADDRESS());
+	return std::malloc(bytes == 0 ? 1 : bytes);
+}
+
+void operator delete(void *p) GLFRAMEWORK_NOEXCEPT{ std::free(p); }
+void operator delete[](void *p) GLFRAMEWORK_NOEXCEPT{ std::free(p); }
+void operator delete(void *p, size_t) GLFRAMEWORK_NOEXCEPT{ std::free(p); }
+void operator delete[](void *p, size_t) GLFRAMEWORK_NOEXCEPT{ std::free(p); }
+void operator delete(void *p, const std::nothrow_t &) GLFRAMEWORK_NOEXCEPT{ std::free(p); }
+void operator delete[](void *p, const std::nothrow_t &) GLFRAMEWORK_NOEXCEPT{ std::free(p); }
+
+namespace glFrameworkBasic {
+#endif
+
+	AllocationTracker::AllocationTracker()
+	{
+		enabled = false;
+		guardWarmup = 0;
+		Clear();
+	}
+
+	AllocationTracker::~AllocationTracker()
+	{
+		if (currentTracker == this) currentTracker = NULL;
+	}
+
+	bool AllocationTracker::IsCompiledIn(){
+#if defined(GLFRAMEWORK_TRACK_ALLOCATIONS)
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	void AllocationTracker::SetEnabled(bool doEnable){
+		if (doEnable && !enabled) Clear();
+		enabled = doEnable;
+	}
+
+	void AllocationTracker::SetGuard(unsigned int warmupFrames){
+		guardWarmup = warmupFrames;
+		violations = 0;
+		if (warmupFrames > 0) SetEnabled(true);
+	}
+
+	void AllocationTracker::BeginFrame(){
+		if (!enabled) return;
+		currentCount = 0;
+		frameViolations = 0;
+		firstViolation = NULL;
+		firstViolationPhase = NULL;
+		inFrame = true;
+	}
+
+	void AllocationTracker::EndFrame(){
+		if (!enabled || !inFrame) return;
+		inFrame = false;
+		std::copy(current, current + currentCount, last);
+		lastCount = currentCount;
+		frames++;
+		if (frameViolations > 0) {
+			std::cerr << "Allocation guard: frame " << frames << " made " << frameViolations
+				<< " heap allocations, first in \"" << firstViolationPhase
+				<< "\" from " << firstViolation << std::endl;
+		}
+	}
+
+	void AllocationTracker::Record(size_t bytes, const void *site){
+		if (!enabled || !inFrame) return;
+		const char *phase = currentPhase != NULL ? currentPhase : OTHER_PHASE;
+
+		// Phase totals for this frame. Phases are few, a linear scan is enough.
+		unsigned int i = 0;
+		while (i < currentCount && current[i].name != phase) i++;
+		if (i == currentCount) {
+			if (currentCount < MAX_PHASES) {
+				current[i].name = phase;
+				current[i].allocations = 0;
+				current[i].bytes = 0;
+				currentCount++;
+			}
+			else i = MAX_PHASES - 1;
+		}
+		current[i].allocations++;
+		current[i].bytes += bytes;
+
+		// Call site totals since enabling.
+		unsigned int slot = hashSite(site, phase) % MAX_SITES;
+		unsigned int probes = 0;
+		while (probes < MAX_SITES && sites[slot].allocations > 0 &&
+			(sites[slot].address != site || sites[slot].phase != phase)) {
+			slot = (slot + 1) % MAX_SITES;
+			probes++;
+		}
+		if (probes == MAX_SITES) siteOverflow++;
+		else {
+			if (sites[slot].allocations == 0) {
+				sites[slot].address = site;
+				sites[slot].phase = phase;
+			}
+			sites[slot].allocations++;
+			sites[slot].bytes += bytes;
+		}
+
+		if (guardWarmup > 0 && frames >= guardWarmup) {
+			violations++;
+			if (frameViolations++ == 0) {
+				firstViolation = site;
+				firstViolationPhase = phase;
+			}
+			// Break here in the debugger, the allocating code is up the stack.
+			assert(!"heap allocation in a guarded frame");
+		}
+	}
+
+	void AllocationTracker::LastFrame(std::vector<AllocationStats> &out) const {
+		out.clear();
+		for (unsigned int i = 0; i < lastCount; i++) {
+			AllocationStats stats = { last[i].name, last[i].allocations, last[i].bytes };
+			out.push_back(stats);
+		}
+	}
+
+	void AllocationTracker::Sites(std::vector<AllocationSite> &out) const {
+		out.clear();
+		for (unsigned int i = 0; i < MAX_SITES; i++) {
+			if (sites[i].allocations > 0) out.push_back(sites[i]);
+		}
+		std::sort(out.begin(), out.end(), moreAllocations);
+	}
+
+	void AllocationTracker::WriteSummary(std::ostream &out) const {
+		std::vector<AllocationStats> phases;
+		LastFrame(phases);
+		out << std::left << std::setw(24) << "phase" << std::right
+			<< std::setw(10) << "allocs" << std::setw(12) << "bytes" << "\n";
+		for (size_t i = 0; i < phases.size(); i++) {
+			out << std::left << std::setw(24) << phases[i].phase << std::right
+				<< std::setw(10) << phases[i].allocations << std::setw(12) << phases[i].bytes << "\n";
+		}
+
+		std::vector<AllocationSite> top;
+		Sites(top);
+		if (top.size() > 10) top.resize(10);
+		out << std::left << std::setw(24) << "site" << std::right
+			<< std::setw(10) << "allocs" << std::setw(12) << "bytes" << "  phase\n";
+		for (size_t i = 0; i < top.size(); i++) {
+			out << std::left << std::setw(24) << top[i].address << std::right
+				<< std::setw(10) << top[i].allocations << std::setw(12) << top[i].bytes
+				<< "  " << top[i].phase << "\n";
+		}
+	}
+
+	void AllocationTracker::Clear(){
+		inFrame = false;
+		frames = 0;
+		violations = 0;
+		frameViolations = 0;
+		firstViolation = NULL;
+		firstViolationPhase = NULL;
+		currentCount = 0;
+		lastCount = 0;
+		for (unsigned int i = 0; i < MAX_SITES; i++) {
+			sites[i].phase = NULL;
+			sites[i].address = NULL;
+			sites[i].allocations = 0;
+			sites[i].bytes = 0;
+		}
+		siteOverflow = 0;
+	}
+
+	AllocationTracker *AllocationTracker::Current(){
+		return currentTracker;
+	}
+
+	void AllocationTracker::SetCurrent(AllocationTracker *tracker){
+		currentTracker = tracker;
+	}
+
+	const char *AllocationTracker::CurrentPhase(){
+		return currentPhase;
+	}
+
+	void AllocationTracker::SetCurrentPhase(const char *phase){
+		currentPhase = phase;
+	}
+}
@@ -0,0 +1,161 @@
+///////////////////////////////////////////////////////////////////////////////
+/// GlFrameworkBasic is free software : you can redistribute it and or modify
+/// it under the terms of the GNU General Public License as published by
+/// the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// GlFrameworkBasic is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with GlFrameworkBasic. If not, see <http://www.gnu.org/licenses/>.
+///
+/// Author: Evan Edstrom
+/// Date: 11/17/2013
+/// Website: http://evanedstrom.com/glstart
+/// Email: contact@evanedstrom.com
+///
+///////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+#include <cstddef>
+#include <ostream>
+#include <vector>
+
+namespace glFrameworkBasic {
+	/// <summary>Heap allocations made in one frame phase.</summary>
+	struct AllocationStats
+	{
+		const char *phase;		// Innermost profiler scope name, or "other"
+		unsigned int allocations;
+		size_t bytes;
+	};
+
+	/// <summary>Heap allocations from one call site in one phase, since tracking was enabled.</summary>
+	struct AllocationSite
+	{
+		const char *phase;
+		const void *address;	// Return address of operator new; resolve with addr2line or a debugger
+		unsigned int allocations;
+		size_t bytes;
+	};
+
+	/**
+	* AllocationTracker counts the heap allocations Engine::display() makes,
+	* per frame phase: every GLFRAMEWORK_PROFILE_SCOPE names a phase, and an
+	* allocation is booked to the innermost one open on its thread. It also
+	* keeps the call sites, and can act as a guard: after a number of warm-up
+	* frames any allocation inside a frame is a violation, which fails an
+	* assert in debug builds so the debugger stops at the allocating code.
+	* Counting hooks the global operator new, which is only replaced when the
+	* framework is built with GLFRAMEWORK_TRACK_ALLOCATIONS defined; without it
+	* the tracker stays empty and costs nothing. Only allocations made on the
+	* thread running the frame are counted, not those of job system workers.
+	* Tables have fixed size, so recording never allocates itself.
+	*/
+	class AllocationTracker
+	{
+	public:
+		/// <summary>Distinct phases kept; later ones are booked to the last entry.</summary>
+		static const unsigned int MAX_PHASES = 32;
+
+		/// <summary>Distinct call sites kept; later ones are only counted in SiteOverflow().</summary>
+		static const unsigned int MAX_SITES = 256;
+
+		AllocationTracker();
+
+		/// <summary>Destructor. Stops being current on the calling thread.</summary>
+		~AllocationTracker();
+
+		/// <summary>True when the framework was built with GLFRAMEWORK_TRACK_ALLOCATIONS.</summary>
+		static bool IsCompiledIn();
+
+		/// <summary>Start or stop counting. Default disabled.</summary>
+		void SetEnabled(bool doEnable);
+
+		/// <summary>True while counting.</summary>
+		bool IsEnabled() const { return enabled; }
+
+		/// <summary>
+		/// Flag allocations in frames after the first warmupFrames counted
+		/// ones. Enables counting. 0 turns the guard off.
+		/// </summary>
+		void SetGuard(unsigned int warmupFrames);
+
+		/// <summary>Allocations the guard flagged since it was set.</summary>
+		unsigned int GuardViolations() const { return violations; }
+
+		/// <summary>Marks the start of a frame. Clears the frame's phase counts.</summary>
+		void BeginFrame();
+
+		/// <summary>
+		/// Marks the end of a frame: its phase counts become LastFrame(), and a
+		/// guarded frame that allocated is reported on std::cerr.
+		/// </summary>
+		void EndFrame();
+
+		/// <summary>Phases that allocated in the last finished frame.</summary>
+		void LastFrame(std::vector<AllocationStats> &out) const;
+
+		/// <summary>Call sites recorded since tracking was enabled, most allocations first.</summary>
+		void Sites(std::vector<AllocationSite> &out) const;
+
+		/// <summary>Allocations whose call site did not fit the table.</summary>
+		unsigned int SiteOverflow() const { return siteOverflow; }
+
+		/// <summary>Frames finished since tracking was enabled.</summary>
+		unsigned int FrameCount() const { return frames; }
+
+		/// <summary>Writes the last frame's phases and the top call sites as a text table.</summary>
+		void WriteSummary(std::ostream &out) const;
+
+		/// <summary>Drops all counts, call sites and violations.</summary>
+		void Clear();
+
+		/// <summary>Books one allocation. Called by the replaced operator new.</summary>
+		void Record(size_t bytes, const void *site);
+
+		/// <summary>Tracker the calling thread's allocations are booked to, or NULL.</summary>
+		static AllocationTracker *Current();
+
+		/// <summary>Makes tracker current on the calling thread. NULL stops booking.</summary>
+		static void SetCurrent(AllocationTracker *tracker);
+
+		/// <summary>Phase new allocations on the calling thread are booked to, or NULL.</summary>
+		static const char *CurrentPhase();
+
+		/// <summary>Sets the calling thread's phase. ProfileScope does this when tracking is compiled in.</summary>
+		static void SetCurrentPhase(const char *phase);
+
+	private:
+		struct Phase {
+			const char *name;
+			unsigned int allocations;
+			size_t bytes;
+		};
+
+		bool enabled;
+		bool inFrame;
+		unsigned int frames;
+		unsigned int guardWarmup;		// 0 when the guard is off
+		unsigned int violations;
+		unsigned int frameViolations;	// In the frame being counted
+		const void *firstViolation;		// Call site of the frame's first violation
+		const char *firstViolationPhase;
+
+		Phase current[MAX_PHASES];		// Frame being counted
+		unsigned int currentCount;
+		Phase last[MAX_PHASES];			// Last finished frame
+		unsigned int lastCount;
+
+		AllocationSite sites[MAX_SITES];	// Open addressing on address and phase
+		unsigned int siteOverflow;
+
+		// Copy is not allowed, current threads may point at it.
+		AllocationTracker(const AllocationTracker &);
+		AllocationTracker &operator=(const AllocationTracker &);
+	};
+}
@@ -0,0 +1,57 @@
+///////////////////////////////////////////////////////////////////////////////
+/// GlFrameworkBasic is free software : you can redistribute it and or modify
+/// it under the terms of the GNU General Public License as published by
+/// the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// GlFrameworkBasic is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with GlFrameworkBasic. If not, see <http://www.gnu.org/licenses/>.
+///
+/// Author: Evan Edstrom
+/// Date: 11/17/2013
+/// Website: http://evanedstrom.com/glstart
+/// Email: contact@evanedstrom.com
+///
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <vector>
+
+#include "Element.h"
+
+namespace glFrameworkBasic {
+	/// <summary>Two elements whose bounds overlap.</summary>
+	struct ElementPair {
+		Element *a;
+		Element *b;
+	};
+
+	/**
+	* Broadphase finds the pairs of elements whose bounding boxes overlap, so
+	* collision code only runs exact tests on candidates instead of every
+	* pair. Engine calls Update() after each update step with the element
+	* list, then FindPairs(), and hands each pair to Engine::collide().
+	*/
+	class Broadphase
+	{
+	public:
+		virtual ~Broadphase() {}
+
+		/// <summary>
+		/// Brings the structure in line with the current element bounds
+		/// (Element::GetWorldBounds()). Elements not in the list are dropped.
+		/// </summary>
+		virtual void Update(const std::vector<Element *> &elements) = 0;
+
+		/// <summary>
+		/// Replaces pairs with every overlapping pair, each reported once.
+		/// Reuses the vector's storage.
+		/// </summary>
+		virtual void FindPairs(std::vector<ElementPair> &pairs) = 0;
+	};
+}
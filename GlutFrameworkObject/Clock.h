@@ -0,0 +1,51 @@
+///////////////////////////////////////////////////////////////////////////////
+/// GlFrameworkBasic is free software : you can redistribute it and or modify
+/// it under the terms of the GNU General Public License as published by
+/// the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// GlFrameworkBasic is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with GlFrameworkBasic. If not, see <http://www.gnu.org/licenses/>.
+///
+/// Author: Evan Edstrom
+/// Date: 11/17/2013
+/// Website: http://evanedstrom.com/glstart
+/// Email: contact@evanedstrom.com
+///
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+namespace glFrameworkBasic {
+	/**
+	* High resolution monotonic clock. Uses QueryPerformanceCounter on Windows
+	* (the Visual Studio 2013 steady_clock is not high resolution) and
+	* std::chrono::steady_clock elsewhere.
+	*/
+	class Clock
+	{
+	public:
+		/// <summary>Starts the clock at zero.</summary>
+		Clock();
+
+		/// <summary>Restarts the clock at zero.</summary>
+		void Reset();
+
+		/// <summary>Seconds elapsed since construction or the last Reset().</summary>
+		double Seconds() const;
+
+		/// <summary>Raw monotonic tick count, for timestamps.</summary>
+		static long long Ticks();
+
+		/// <summary>Ticks per second for Ticks().</summary>
+		static long long TicksPerSecond();
+
+	private:
+		long long start;
+	};
+}
@@ -0,0 +1,107 @@
+///////////////////////////////////////////////////////////////////////////////
+/// GlFrameworkBasic is free software : you can redistribute it and or modify
+/// it under the terms of the GNU General Public License as published by
+/// the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// GlFrameworkBasic is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with GlFrameworkBasic. If not, see <http://www.gnu.org/licenses/>.
+///
+/// Author: Evan Edstrom
+/// Date: 11/17/2013
+/// Website: http://evanedstrom.com/glstart
+/// Email: contact@evanedstrom.com
+///
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include "CommandQueue.h"
+
+namespace glFrameworkBasic {
+	CommandQueue::CommandQueue() : head(&stub), tail(&stub), size(0), nextTicket(1)
+	{
+		stub.next.store(NULL, std::memory_order_relaxed);
+	}
+
+	CommandQueue::~CommandQueue()
+	{
+		while (Command *command = Pop())
+			delete command;
+	}
+
+	CommandQueue::Command *CommandQueue::makeCommand(CommandType type, CommandTicket ticket, ElementHandle handle){
+		Command *command = new Command();
+		command->type = type;
+		command->ticket = ticket;
+		command->handle = handle;
+		return command;
+	}
+
+	void CommandQueue::push(Command *command){
+		command->next.store(NULL, std::memory_order_relaxed);
+		Command *prev = head.exchange(command, std::memory_order_acq_rel);
+		// Until this store the consumer sees the list end at prev and waits.
+		prev->next.store(command, std::memory_order_release);
+	}
+
+	CommandTicket CommandQueue::Create(const CreateFunc &create){
+		CommandTicket ticket = nextTicket.fetch_add(1, std::memory_order_relaxed);
+		if (ticket == 0) ticket = nextTicket.fetch_add(1, std::memory_order_relaxed);	// Wrapped
+		Command *command = makeCommand(CREATE, ticket, ElementHandle());
+		command->create = create;
+		size.fetch_add(1, std::memory_order_relaxed);
+		push(command);
+		return ticket;
+	}
+
+	void CommandQueue::Update(CommandTicket ticket, const UpdateFunc &update){
+		Command *command = makeCommand(UPDATE, ticket, ElementHandle());
+		command->update = update;
+		size.fetch_add(1, std::memory_order_relaxed);
+		push(command);
+	}
+
+	void CommandQueue::Update(ElementHandle handle, const UpdateFunc &update){
+		Command *command = makeCommand(UPDATE, 0, handle);
+		command->update = update;
+		size.fetch_add(1, std::memory_order_relaxed);
+		push(command);
+	}
+
+	void CommandQueue::Destroy(CommandTicket ticket){
+		size.fetch_add(1, std::memory_order_relaxed);
+		push(makeCommand(DESTROY, ticket, ElementHandle()));
+	}
+
+	void CommandQueue::Destroy(ElementHandle handle){
+		size.fetch_add(1, std::memory_order_relaxed);
+		push(makeCommand(DESTROY, 0, handle));
+	}
+
+	CommandQueue::Command *CommandQueue::Pop(){
+		// Vyukov's intrusive MPSC queue: tail is the oldest node, the stub
+		// is pushed back whenever the consumer reaches the last real node.
+		Command *first = tail;
+		Command *next = first->next.load(std::memory_order_acquire);
+		if (first == &stub) {
+			if (next == NULL) return NULL;
+			tail = next;
+			first = next;
+			next = next->next.load(std::memory_order_acquire);
+		}
+		if (next == NULL) {
+			if (first != head.load(std::memory_order_acquire)) return NULL;	// A push is half done
+			push(&stub);
+			next = first->next.load(std::memory_order_acquire);
+			if (next == NULL) return NULL;
+		}
+		tail = next;
+		size.fetch_sub(1, std::memory_order_relaxed);
+		return first;
+	}
+}
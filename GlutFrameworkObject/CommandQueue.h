@@ -0,0 +1,126 @@
+///////////////////////////////////////////////////////////////////////////////
+/// GlFrameworkBasic is free software : you can redistribute it and or modify
+/// it under the terms of the GNU General Public License as published by
+/// the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// GlFrameworkBasic is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with GlFrameworkBasic. If not, see <http://www.gnu.org/licenses/>.
+///
+/// Author: Evan Edstrom
+/// Date: 11/17/2013
+/// Website: http://evanedstrom.com/glstart
+/// Email: contact@evanedstrom.com
+///
+///////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <functional>
+
+#include "ElementHandle.h"
+
+namespace glFrameworkBasic {
+	class Element;
+	class Engine;
+
+	/// <summary>Names an element created through a CommandQueue. 0 is never issued.</summary>
+	typedef unsigned int CommandTicket;
+
+	/**
+	* CommandQueue lets any thread create, change and remove elements without
+	* touching drawItems. Producers push commands onto a multi-producer,
+	* single-consumer lock-free queue (one atomic exchange per push); the
+	* Engine pops them on the display thread before preDisplayLoop(), at most
+	* SetCommandBudget() per frame.
+	*
+	* Create() returns a ticket right away, so a producer can queue Update()
+	* and Destroy() commands for an element that does not exist yet. Commands
+	* from one thread run in the order they were pushed.
+	*/
+	class CommandQueue
+	{
+	public:
+		typedef std::function<ElementHandle(Engine &)> CreateFunc;
+		typedef std::function<void(Element &)> UpdateFunc;
+
+		enum CommandType { CREATE, UPDATE, DESTROY };
+
+		/// <summary>One queued command. Targets ticket if it is not 0, else handle.</summary>
+		struct Command {
+			CommandType type;
+			CommandTicket ticket;
+			ElementHandle handle;
+			CreateFunc create;		// CREATE: spawns the element, on the display thread
+			UpdateFunc update;		// UPDATE: changes the element, on the display thread
+			std::atomic<Command *> next;
+		};
+
+		CommandQueue();
+
+		/// <summary>Destructor. Drops commands that were never popped.</summary>
+		~CommandQueue();
+
+		/// <summary>
+		/// Queues create, which is called with the engine and must return the
+		/// handle of the element it made (normally from Engine::Spawn()).
+		/// Returns the ticket that later commands can use to refer to it.
+		/// </summary>
+		CommandTicket Create(const CreateFunc &create);
+
+		/// <summary>
+		/// Queues Engine::Spawn<T>() followed by init on the new element.
+		/// Defined in Engine.h.
+		/// </summary>
+		template <class T>
+		CommandTicket Create(const std::function<void(T &)> &init);
+
+		/// <summary>Queues update to be called on the element made by ticket's Create().</summary>
+		void Update(CommandTicket ticket, const UpdateFunc &update);
+
+		/// <summary>Queues update to be called on the element handle refers to.</summary>
+		void Update(ElementHandle handle, const UpdateFunc &update);
+
+		/// <summary>Queues removal of the element made by ticket's Create().</summary>
+		void Destroy(CommandTicket ticket);
+
+		/// <summary>Queues Engine::Despawn() of handle.</summary>
+		void Destroy(ElementHandle handle);
+
+		/// <summary>Commands pushed and not yet popped. Approximate while producers run.</summary>
+		size_t Size() const { return size.load(std::memory_order_relaxed); }
+
+		/// <summary>True when no commands are waiting.</summary>
+		bool Empty() const { return Size() == 0; }
+
+		/// <summary>
+		/// Takes the oldest command, or NULL if none is ready. The caller
+		/// deletes it. Display thread only.
+		/// </summary>
+		Command *Pop();
+
+	private:
+		std::atomic<Command *> head;	// Last pushed, swapped by producers
+		Command *tail;				// Next to pop, consumer only
+		Command stub;				// Keeps the list non-empty
+		std::atomic<size_t> size;
+		std::atomic<CommandTicket> nextTicket;
+
+		/// <summary>Creates a command targeting ticket or handle.</summary>
+		static Command *makeCommand(CommandType type, CommandTicket ticket, ElementHandle handle);
+
+		/// <summary>Links command at the head. Wait-free, any thread.</summary>
+		void push(Command *command);
+
+		// Copy is not allowed, queued commands are owned.
+		CommandQueue(const CommandQueue &);
+		CommandQueue &operator=(const CommandQueue &);
+	};
+}
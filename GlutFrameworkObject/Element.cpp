@@ -20,6 +20,7 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include "Element.h"
+#include "SceneGraph.h"
 
 namespace glFrameworkBasic {
 	Element::Element()
@@ -29,10 +30,27 @@ namespace glFrameworkBasic {
 		xScale = 1.0f; yScale = 1.0f; zScale = 1.0f;
 		rotAngle = 0.0f;
 		show = true;
+		store = NULL;
+		storeSlot = 0;
+		pool = NULL;
+		poolSlot = 0;
+		dirty = true;
+		isStatic = false;
+		drawLayer = 0;
+		layerDirty = true;
+		handleIndex = ElementHandle::NULL_INDEX;
+		graph = NULL;
+		graphNode = 0;
+		parent = NULL;
+		xPrev = 0; yPrev = 0; zPrev = 0; anglePrev = 0;
+		hasPrev = false;
+		xHeld = 0; yHeld = 0; zHeld = 0; angleHeld = 0;
 	}
 
 	Element::~Element()
 	{
+		if (store != NULL) store->Remove(storeSlot);
+		if (graph != NULL) graph->Remove(this);
 	}
 
 	void Element::Draw(){
@@ -57,12 +75,29 @@ namespace glFrameworkBasic {
 		glPopMatrix();		// Restore the model-view matrix
 	}
 
+	bool Element::Submit(RenderBatch &batch){
+		if (!show) return true;
+
+		// Same square as Draw(), as an instance when the batch can:
+		batch.SetColor(1.0f, 1.0f, 1.0f);
+		if (batch.AddInstance(InstanceRenderer::SHAPE_SQUARE)) return true;
+		batch.SetColor(1.0f, 0.0f, 0.0f);				// Red
+		GLuint bl = batch.AddVertex(-0.3f, -0.3f);		// Bottom Left
+		GLuint tl = batch.AddVertex(-0.3f, 0.3f);		// Top Left
+		batch.SetColor(0.0f, 0.0f, 1.0f);				// Blue
+		GLuint tr = batch.AddVertex(0.3f, 0.3f);		// Top Right
+		GLuint br = batch.AddVertex(0.3f, -0.3f);		// Bottom Right
+		batch.AddQuad(bl, tl, tr, br);
+		return true;
+	}
+
 	void Element::Move(){
 		// Increment Positions
 		// Xf = Xi + V*T (Time regulated by clock)
 		xPos += xVel;
 		yPos += yVel;
 		zPos += zVel;
+		if (graph != NULL && (xVel != 0.0f || yVel != 0.0f || zVel != 0.0f)) graph->markDirty(graphNode);
 	}
 
 	void Element::BeforeDraw() {
@@ -76,39 +111,168 @@ namespace glFrameworkBasic {
 	void Element::SetPosition(float x, float y){
 		xPos = x;
 		yPos = y;
+		if (store != NULL) {
+			store->xPos[storeSlot] = x;
+			store->yPos[storeSlot] = y;
+		}
+		changed();
 	}
 	void Element::SetPosition(float x, float y, float z){
 		xPos = x;
 		yPos = y;
 		zPos = z;
+		if (store != NULL) {
+			store->xPos[storeSlot] = x;
+			store->yPos[storeSlot] = y;
+			store->zPos[storeSlot] = z;
+		}
+		changed();
 	}
 	void Element::SetVelocity(float x, float y){
 		xVel = x;
 		yVel = y;
+		changed();
 	}
 	void Element::SetVelocity(float x, float y, float z){
 		xVel = x;
 		yVel = y;
 		zVel = z;
+		changed();
 	}
 	void Element::SetScale(float scale){
 		xScale = scale;
 		yScale = scale;
 		zScale = scale;
+		changed();
 	}
 	void Element::SetScale(float x, float y){
 		xScale = x;
 		yScale = y;
+		changed();
 	}
 	void Element::SetScale(float x, float y, float z){
 		xScale = x;
 		yScale = y;
 		zScale = z;
+		changed();
 	}
 	void Element::SetAngle(float angle){
 		rotAngle = angle;
+		changed();
 	}
 	void Element::ShowObject(bool doShow){
 		show = doShow;
+		changed();
+	}
+
+	Transform Element::GetTransform() const {
+		return Transform::FromTRS(xPos, yPos, zPos, xScale, yScale, rotAngle);
+	}
+
+	Aabb Element::GetBounds() const {
+		return Aabb::FromTransform(GetTransform(), 0.3f, 0.3f);
+	}
+
+	Transform Element::GetWorldTransform() const {
+		return graph != NULL ? graph->World(this) : GetTransform();
+	}
+
+	Aabb Element::GetWorldBounds() const {
+		return parent != NULL ? GetBounds().Transformed(graph->World(parent)) : GetBounds();
+	}
+
+	// Structure-of-arrays store:
+	void Element::BindStore(ElementStore &elementStore){
+		if (store == &elementStore) return;
+		UnbindStore();
+		store = &elementStore;
+		storeSlot = elementStore.Add(this);
+		elementStore.xPos[storeSlot] = xPos; elementStore.yPos[storeSlot] = yPos; elementStore.zPos[storeSlot] = zPos;
+		pushToStore();
+	}
+	void Element::UnbindStore(){
+		if (store == NULL) return;
+		PullFromStore();
+		store->Remove(storeSlot);
+		store = NULL;
+	}
+	void Element::PullFromStore(){
+		if (store == NULL) return;
+		const unsigned int s = storeSlot;
+		xPos = store->xPos[s]; yPos = store->yPos[s]; zPos = store->zPos[s];
+		xVel = store->xVel[s]; yVel = store->yVel[s]; zVel = store->zVel[s];
+		xScale = store->xScale[s]; yScale = store->yScale[s]; zScale = store->zScale[s];
+		rotAngle = store->rotAngle[s];
+		show = store->show[s];
+		if (graph != NULL) graph->markDirty(graphNode);
+	}
+	// Render interpolation:
+	void Element::SavePreviousState(){
+		xPrev = xPos; yPrev = yPos; zPrev = zPos;
+		anglePrev = rotAngle;
+		hasPrev = true;
+	}
+	void Element::BeginInterpolation(float alpha){
+		xHeld = xPos; yHeld = yPos; zHeld = zPos;
+		angleHeld = rotAngle;
+		if (!hasPrev) return;	// Not stepped yet, draw where it is.
+		xPos = xPrev + (xPos - xPrev) * alpha;
+		yPos = yPrev + (yPos - yPrev) * alpha;
+		zPos = zPrev + (zPos - zPrev) * alpha;
+		rotAngle = anglePrev + (rotAngle - anglePrev) * alpha;
+	}
+	void Element::EndInterpolation(){
+		xPos = xHeld; yPos = yHeld; zPos = zHeld;
+		rotAngle = angleHeld;
+	}
+
+	void Element::changed(){
+		dirty = true;
+		layerDirty = true;
+		if (store != NULL) pushToStore();
+		if (graph != NULL) graph->markDirty(graphNode);
+	}
+
+	void Element::MarkDirty(){
+		dirty = true;
+		layerDirty = true;
+		if (graph != NULL) graph->markDirty(graphNode);
+	}
+
+	void Element::SetStatic(bool isStaticElement){
+		if (isStatic == isStaticElement) return;
+		isStatic = isStaticElement;
+		changed();	// Moves between the layer and the per-frame pass
+	}
+
+	void Element::SetDrawLayer(unsigned char layer){
+		if (drawLayer == layer) return;
+		drawLayer = layer;
+		changed();
+	}
+
+	unsigned int Element::GetMaterialId() const {
+		return 0;
+	}
+
+	bool Element::IsAnimating() const {
+		return show && (xVel != 0.0f || yVel != 0.0f || zVel != 0.0f);
+	}
+
+	void Element::pullStep(){
+		const unsigned int s = storeSlot;
+		xPrev = store->xPrev[s]; yPrev = store->yPrev[s]; zPrev = store->zPrev[s];
+		anglePrev = rotAngle;	// Not integrated
+		hasPrev = true;
+		xPos = store->xPos[s]; yPos = store->yPos[s]; zPos = store->zPos[s];
+		if (graph != NULL) graph->markDirty(graphNode);
+	}
+
+	void Element::pushToStore(){
+		const unsigned int s = storeSlot;
+		store->xVel[s] = xVel; store->yVel[s] = yVel; store->zVel[s] = zVel;
+		store->xScale[s] = xScale; store->yScale[s] = yScale; store->zScale[s] = zScale;
+		store->rotAngle[s] = rotAngle;
+		store->show[s] = show;
 	}
 }
\ No newline at end of file
@@ -22,7 +22,16 @@
 #pragma once
 #include <GL\glut.h>
 
+#include "Aabb.h"
+#include "ElementHandle.h"
+#include "ElementPool.h"
+#include "ElementStore.h"
+#include "RenderBatch.h"
+#include "Transform.h"
+
 namespace glFrameworkBasic {
+	class SceneGraph;
+
 	/**
 	* Gameplay Element keeps information about an object's position and velocity
 	* so it can be drawn in 3D space. Contains the logic to update an element's
@@ -38,14 +47,71 @@ namespace glFrameworkBasic {
 		float rotAngle; 
 		bool show;
 
+	private:
+		friend class ElementStore;
+		ElementStore *store;		// Store this element is bound to, or NULL
+		unsigned int storeSlot;		// Slot in store, kept current by ElementStore
+
+		friend class Engine;
+		ElementPoolBase *pool;		// Pool that allocated this element, or NULL for new
+		friend class ElementPoolBase;
+		unsigned int poolSlot;		// Index in the pool's live list
+		unsigned int handleIndex;	// Engine handle table slot, or ElementHandle::NULL_INDEX
+
+		friend class SceneGraph;
+		SceneGraph *graph;			// Graph holding this element's node, or NULL
+		unsigned int graphNode;		// Node index, kept current by SceneGraph
+		Element *parent;			// Transform is relative to this element, or NULL
+
+		// State before the last update step, for render interpolation.
+		float xPrev, yPrev, zPrev, anglePrev;
+		bool hasPrev;
+		// Real state stashed while drawing at an interpolated position.
+		float xHeld, yHeld, zHeld, angleHeld;
+
+		// Set by the mutators, cleared by Engine once the change is drawn.
+		bool dirty;
+
+		bool isStatic;		// Drawn into the Engine's static layer
+		unsigned char drawLayer;	// Sorted draw order before zPos
+		bool layerDirty;	// Changed since the static layer was rendered
+
+		/// <summary>
+		/// Copies the member values other than position into the bound store
+		/// slot. Position members may lag the slot until Engine syncs them, so
+		/// BindStore() and SetPosition() write it themselves.
+		/// </summary>
+		void pushToStore();
+
+		/// <summary>
+		/// Copies position and previous position from the bound store slot, the
+		/// only members Integrate() changes. Stands in for SavePreviousState()
+		/// and PullFromStore() of the steps since the last pull.
+		/// </summary>
+		void pullStep();
+
+		/// <summary>Marks the element dirty and writes through to the store. Called by every mutator.</summary>
+		void changed();
+
+	protected:
+		/// <summary>
+		/// Flags a visual change made without the Set functions, so an Engine
+		/// redrawing on demand draws it and attached children follow it.
+		/// Call it from Move() overrides that change position, scale or angle
+		/// directly on an element with children.
+		/// </summary>
+		void MarkDirty();
+
 	public:
 		/// Initializes positions and velocities to 0.
 		/// Initializes scales to 1
 		/// Initializes show to true.
 		Element();
 
-		/// Destructor. No dynamic memory in this class.
-		~Element();
+		/// Destructor. No dynamic memory in this class. Releases the store slot
+		/// if bound. Virtual so derived elements are destroyed correctly through
+		/// Element pointers.
+		virtual ~Element();
 
 		/// <summary>
 		/// Draws element on screen.
@@ -55,6 +121,16 @@ namespace glFrameworkBasic {
 		/// </summary>
 		virtual void Draw();
 
+		/// <summary>
+		/// Batched alternative to Draw(), used when Engine batching is enabled.
+		/// Adds the element's geometry to the batch in local coordinates; Engine
+		/// has already set the batch transform from GetTransform().
+		/// Return false to have Engine fall back to Draw() for this element.
+		/// Generic function submits the same red/blue square as Draw().
+		/// Overwrite together with Draw() if a different shape is required.
+		/// </summary>
+		virtual bool Submit(RenderBatch &batch);
+
 		/// <summary>
 		/// Updates position of element. Adds velocity to position.
 		/// Does not handle rotational velocity.
@@ -95,6 +171,106 @@ namespace glFrameworkBasic {
 
 		/// <summary>Enable / Disable whether object should be shown.</summary>
 		void ShowObject(bool doShow);
+
+		/// <summary>
+		/// True if the object is shown. Engine skips hidden elements in the
+		/// draw pass without calling any of their draw functions.
+		/// </summary>
+		bool IsShown() const { return show; }
+
+		/// <summary>
+		/// Flag the element as static background. With Engine::SetStaticLayer()
+		/// it is drawn once into a cached layer, and again only when one of its
+		/// Set functions is called. Static elements should not move on their own.
+		/// </summary>
+		void SetStatic(bool isStaticElement);
+
+		/// <summary>True if the element is flagged static.</summary>
+		bool IsStatic() const { return isStatic; }
+
+		/// <summary>
+		/// Draw layer used by Engine::SetDrawSorting(). Lower layers are drawn
+		/// first, then lower zPos within a layer. Default 0.
+		/// </summary>
+		void SetDrawLayer(unsigned char layer);
+
+		/// <summary>Draw layer set with SetDrawLayer().</summary>
+		unsigned char GetDrawLayer() const { return drawLayer; }
+
+		/// <summary>
+		/// Id of the GL state (color, texture) Draw() or Submit() sets, 0 - 65535.
+		/// With Engine::SetDrawSorting() elements of one type, layer and depth
+		/// are drawn grouped by it. Generic function returns 0.
+		/// </summary>
+		virtual unsigned int GetMaterialId() const;
+
+		/// <summary>
+		/// True while the element changes on its own from step to step, so an
+		/// Engine redrawing on demand keeps drawing. Generic function returns
+		/// true for a shown element with velocity. Overwrite when Move()
+		/// animates in other ways.
+		/// </summary>
+		virtual bool IsAnimating() const;
+
+		/// <summary>
+		/// Transform from position, scale and angle. Local to world, or local
+		/// to parent while attached with Engine::Attach().
+		/// </summary>
+		Transform GetTransform() const;
+
+		/// <summary>Element this one is attached to, or NULL.</summary>
+		Element *GetParent() const { return parent; }
+
+		/// <summary>
+		/// Local to world transform including the parents, as of the engine's
+		/// last scene graph update. GetTransform() for unattached elements.
+		/// </summary>
+		Transform GetWorldTransform() const;
+
+		/// <summary>GetBounds() mapped to world space by the parent's world transform.</summary>
+		Aabb GetWorldBounds() const;
+
+		/// <summary>
+		/// World space box around what Draw() covers. Used by collision
+		/// broadphases. Generic function bounds the 0.6 unit square, rotated
+		/// and scaled. Overwrite when Draw() draws a different shape.
+		/// </summary>
+		virtual Aabb GetBounds() const;
+
+		/// <summary>
+		/// Moves this element's position, velocity, scale, angle and show flag
+		/// into a slot of a structure-of-arrays store. The Set functions keep
+		/// writing through to the slot. Engine integrates bound elements in one
+		/// SIMD pass over its elementStore instead of calling Move(), so an
+		/// overridden Move() is not used while bound.
+		/// </summary>
+		void BindStore(ElementStore &elementStore);
+
+		/// <summary>Copies the slot back into the element and releases it.</summary>
+		void UnbindStore();
+
+		/// <summary>True while the element's state lives in a store.</summary>
+		bool IsStoreBound() const { return store != NULL; }
+
+		/// <summary>Refreshes the member values from the bound store slot.</summary>
+		void PullFromStore();
+
+		/// <summary>
+		/// Records position and angle as the state before an update step.
+		/// Called by Engine before every fixed step.
+		/// </summary>
+		void SavePreviousState();
+
+		/// <summary>
+		/// Temporarily replaces position and angle with the blend of the previous
+		/// and current state, so Draw() renders between two update steps.
+		/// alpha 0 is the previous state, 1 the current. Must be paired with
+		/// EndInterpolation().
+		/// </summary>
+		void BeginInterpolation(float alpha);
+
+		/// <summary>Restores the state replaced by BeginInterpolation().</summary>
+		void EndInterpolation();
 	};
 
 }
\ No newline at end of file
@@ -0,0 +1,65 @@
+///////////////////////////////////////////////////////////////////////////////
+/// GlFrameworkBasic is free software : you can redistribute it and or modify
+/// it under the terms of the GNU General Public License as published by
+/// the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// GlFrameworkBasic is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with GlFrameworkBasic. If not, see <http://www.gnu.org/licenses/>.
+///
+/// Author: Evan Edstrom
+/// Date: 11/17/2013
+/// Website: http://evanedstrom.com/glstart
+/// Email: contact@evanedstrom.com
+///
+///////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+#include <type_traits>
+
+#include "Element.h"
+#include "RenderBatch.h"
+
+namespace glFrameworkBasic {
+	/**
+	* Call policies for Engine's update and draw loops. VirtualDispatch calls
+	* through the vtable and works for any Element. ExactDispatch<T> is used
+	* for elements known to be exactly a T (those made by Spawn<T>()): its
+	* calls are qualified, so the compiler binds and can inline them, and the
+	* Has flags let a loop drop BeforeDraw() / AfterDraw() when T does not
+	* override them.
+	*/
+	struct VirtualDispatch
+	{
+		static const bool HasBeforeDraw = true;
+		static const bool HasAfterDraw = true;
+
+		static void Move(Element *e) { e->Move(); }
+		static void BeforeDraw(Element *e) { e->BeforeDraw(); }
+		static void Draw(Element *e) { e->Draw(); }
+		static bool Submit(Element *e, RenderBatch &batch) { return e->Submit(batch); }
+		static void AfterDraw(Element *e) { e->AfterDraw(); }
+		static Aabb GetBounds(const Element *e) { return e->GetBounds(); }
+	};
+
+	template <class T>
+	struct ExactDispatch
+	{
+		// &T::BeforeDraw still has Element's member pointer type unless T overrides it.
+		static const bool HasBeforeDraw = !std::is_same<decltype(&T::BeforeDraw), void (Element::*)()>::value;
+		static const bool HasAfterDraw = !std::is_same<decltype(&T::AfterDraw), void (Element::*)()>::value;
+
+		static void Move(Element *e) { static_cast<T *>(e)->T::Move(); }
+		static void BeforeDraw(Element *e) { static_cast<T *>(e)->T::BeforeDraw(); }
+		static void Draw(Element *e) { static_cast<T *>(e)->T::Draw(); }
+		static bool Submit(Element *e, RenderBatch &batch) { return static_cast<T *>(e)->T::Submit(batch); }
+		static void AfterDraw(Element *e) { static_cast<T *>(e)->T::AfterDraw(); }
+		static Aabb GetBounds(const Element *e) { return static_cast<const T *>(e)->T::GetBounds(); }
+	};
+}
@@ -0,0 +1,49 @@
+///////////////////////////////////////////////////////////////////////////////
+/// GlFrameworkBasic is free software : you can redistribute it and or modify
+/// it under the terms of the GNU General Public License as published by
+/// the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// GlFrameworkBasic is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with GlFrameworkBasic. If not, see <http://www.gnu.org/licenses/>.
+///
+/// Author: Evan Edstrom
+/// Date: 11/17/2013
+/// Website: http://evanedstrom.com/glstart
+/// Email: contact@evanedstrom.com
+///
+///////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+namespace glFrameworkBasic {
+	/**
+	* ElementHandle names an element created with Engine::Spawn(). It is an
+	* index into the engine's handle table plus the generation of that slot.
+	* Despawning bumps the generation, so an old handle to a reused slot no
+	* longer resolves: Engine::Get() returns NULL instead of a different element.
+	*/
+	struct ElementHandle
+	{
+		unsigned int index;			// Slot in the engine's handle table
+		unsigned int generation;	// Slot generation when the handle was made
+
+		/// <summary>Null handle, never resolves.</summary>
+		ElementHandle() : index(NULL_INDEX), generation(0) {}
+		ElementHandle(unsigned int i, unsigned int g) : index(i), generation(g) {}
+
+		/// <summary>True for the default constructed handle.</summary>
+		bool IsNull() const { return index == NULL_INDEX; }
+
+		bool operator==(const ElementHandle &o) const { return index == o.index && generation == o.generation; }
+		bool operator!=(const ElementHandle &o) const { return !(*this == o); }
+
+		static const unsigned int NULL_INDEX = 0xffffffffu;
+	};
+}
@@ -0,0 +1,39 @@
+///////////////////////////////////////////////////////////////////////////////
+/// GlFrameworkBasic is free software : you can redistribute it and or modify
+/// it under the terms of the GNU General Public License as published by
+/// the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// GlFrameworkBasic is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with GlFrameworkBasic. If not, see <http://www.gnu.org/licenses/>.
+///
+/// Author: Evan Edstrom
+/// Date: 11/17/2013
+/// Website: http://evanedstrom.com/glstart
+/// Email: contact@evanedstrom.com
+///
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include "ElementPool.h"
+#include "Element.h"
+
+namespace glFrameworkBasic {
+	void ElementPoolBase::track(Element *element){
+		element->poolSlot = (unsigned int)live.size();
+		live.push_back(element);
+	}
+
+	void ElementPoolBase::untrack(Element *element){
+		const unsigned int slot = element->poolSlot;
+		Element *last = live.back();
+		live[slot] = last;
+		last->poolSlot = slot;
+		live.pop_back();
+	}
+}
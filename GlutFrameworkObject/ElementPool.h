@@ -0,0 +1,152 @@
+///////////////////////////////////////////////////////////////////////////////
+/// GlFrameworkBasic is free software : you can redistribute it and or modify
+/// it under the terms of the GNU General Public License as published by
+/// the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// GlFrameworkBasic is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with GlFrameworkBasic. If not, see <http://www.gnu.org/licenses/>.
+///
+/// Author: Evan Edstrom
+/// Date: 11/17/2013
+/// Website: http://evanedstrom.com/glstart
+/// Email: contact@evanedstrom.com
+///
+///////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace glFrameworkBasic {
+	class Element;
+
+	/// <summary>
+	/// Type-erased face of ElementPool so Engine can return an element to the
+	/// pool it came from without knowing its type.
+	/// </summary>
+	class ElementPoolBase
+	{
+	public:
+		ElementPoolBase() : typeIndex(0) {}
+		virtual ~ElementPoolBase() {}
+
+		/// <summary>Destroys an element created by this pool and frees its slot.</summary>
+		virtual void Release(Element *element) = 0;
+
+		/// <summary>Number of live elements.</summary>
+		size_t Size() const { return live.size(); }
+
+		/// <summary>
+		/// Live elements, densely packed in no particular order. Lets Engine
+		/// walk one concrete type at a time.
+		/// </summary>
+		Element *const *Live() const { return live.empty() ? NULL : &live[0]; }
+
+		/// <summary>
+		/// Live element index. Engine's loops read through this on every
+		/// iteration, so a Spawn() from Move() or Draw() cannot leave them on
+		/// a reallocated array.
+		/// </summary>
+		Element *operator[](size_t index) const { return live[index]; }
+
+	protected:
+		std::vector<Element *> live;
+
+		friend class Engine;
+		unsigned int typeIndex;		// Engine type group index + 1, used in draw sort keys
+
+		/// <summary>Adds a new element to the live list.</summary>
+		void track(Element *element);
+
+		/// <summary>Removes an element from the live list, moving the last one into its place.</summary>
+		void untrack(Element *element);
+	};
+
+	/**
+	* ElementPool allocates elements of one type from fixed size chunks.
+	* Create() and Release() are O(1): freed slots go on an intrusive free list
+	* and are reused before a new chunk is allocated, so spawning and despawning
+	* thousands of elements a frame does not touch the heap once the pool has
+	* grown to its working size. Chunks are only freed with the pool.
+	* Elements still alive when the pool is destroyed are not destructed;
+	* Engine releases all of its elements before its pools.
+	*/
+	template <class T, unsigned int ChunkSize = 256>
+	class ElementPool : public ElementPoolBase
+	{
+	public:
+		ElementPool() : freeList(NULL) {}
+
+		~ElementPool()
+		{
+			for (size_t i = 0; i < chunks.size(); i++)
+				delete[] chunks[i];
+		}
+
+		/// <summary>Constructs a T in a free slot, growing by a chunk if none is left.</summary>
+		template <class... Args>
+		T *Create(Args&&... args)
+		{
+			if (freeList == NULL) grow();
+			FreeSlot *slot = freeList;
+			freeList = slot->next;
+			T *element = new (slot) T(std::forward<Args>(args)...);
+			track(element);
+			return element;
+		}
+
+		void Release(Element *element)
+		{
+			T *object = static_cast<T *>(element);
+			untrack(element);
+			object->~T();
+			FreeSlot *slot = reinterpret_cast<FreeSlot *>(object);
+			slot->next = freeList;
+			freeList = slot;
+		}
+
+		/// <summary>Grows the pool so at least count elements fit without allocating.</summary>
+		void Reserve(size_t count)
+		{
+			while (Capacity() < count) grow();
+		}
+
+		/// <summary>Number of elements that fit in the allocated chunks.</summary>
+		size_t Capacity() const { return chunks.size() * ChunkSize; }
+
+	private:
+		// A free slot holds the link to the next one in place of the object.
+		struct FreeSlot { FreeSlot *next; };
+		typedef typename std::aligned_storage<(sizeof(T) > sizeof(FreeSlot) ? sizeof(T) : sizeof(FreeSlot)),
+			std::alignment_of<T>::value>::type Storage;
+
+		std::vector<Storage *> chunks;
+		FreeSlot *freeList;
+
+		/// <summary>Allocates a chunk and threads its slots onto the free list.</summary>
+		void grow()
+		{
+			Storage *chunk = new Storage[ChunkSize];
+			chunks.push_back(chunk);
+			// Link back to front so slots are handed out in address order.
+			for (unsigned int i = ChunkSize; i-- > 0;) {
+				FreeSlot *slot = reinterpret_cast<FreeSlot *>(&chunk[i]);
+				slot->next = freeList;
+				freeList = slot;
+			}
+		}
+
+		// Copy is not allowed, the chunks are owned.
+		ElementPool(const ElementPool &);
+		ElementPool &operator=(const ElementPool &);
+	};
+}
@@ -0,0 +1,107 @@
+///////////////////////////////////////////////////////////////////////////////
+/// GlFrameworkBasic is free software : you can redistribute it and or modify
+/// it under the terms of the GNU General Public License as published by
+/// the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// GlFrameworkBasic is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with GlFrameworkBasic. If not, see <http://www.gnu.org/licenses/>.
+///
+/// Author: Evan Edstrom
+/// Date: 11/17/2013
+/// Website: http://evanedstrom.com/glstart
+/// Email: contact@evanedstrom.com
+///
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ElementStore.h"
+#include "Element.h"
+
+#include <cstring>
+
+namespace glFrameworkBasic {
+	ElementStore::ElementStore()
+	{
+		count = 0;
+	}
+
+	ElementStore::~ElementStore()
+	{
+		Clear();
+	}
+
+	unsigned int ElementStore::Add(Element *owner){
+		const size_t slot = count++;
+		const size_t needed = SimdRoundUp(count);
+		AlignedFloatArray *arrays[] = { &xPos, &yPos, &zPos, &xVel, &yVel, &zVel,
+			&xScale, &yScale, &zScale, &rotAngle, &xPrev, &yPrev, &zPrev };
+		for (int i = 0; i < 13; i++) arrays[i]->Reserve(needed);
+
+		xPos[slot] = 0; yPos[slot] = 0; zPos[slot] = 0;
+		xVel[slot] = 0; yVel[slot] = 0; zVel[slot] = 0;
+		xScale[slot] = 1.0f; yScale[slot] = 1.0f; zScale[slot] = 1.0f;
+		rotAngle[slot] = 0.0f;
+		xPrev[slot] = 0; yPrev[slot] = 0; zPrev[slot] = 0;
+		if (show.size() < count) show.resize(count);
+		show[slot] = true;
+		if (owners.size() < count) owners.resize(count);
+		owners[slot] = owner;
+		return (unsigned int)slot;
+	}
+
+	void ElementStore::Remove(unsigned int slot){
+		if (slot >= count) return;
+		const size_t last = count - 1;
+		if (slot != last) {
+			xPos[slot] = xPos[last]; yPos[slot] = yPos[last]; zPos[slot] = zPos[last];
+			xVel[slot] = xVel[last]; yVel[slot] = yVel[last]; zVel[slot] = zVel[last];
+			xScale[slot] = xScale[last]; yScale[slot] = yScale[last]; zScale[slot] = zScale[last];
+			rotAngle[slot] = rotAngle[last];
+			xPrev[slot] = xPrev[last]; yPrev[slot] = yPrev[last]; zPrev[slot] = zPrev[last];
+			show[slot] = show[last];
+			owners[slot] = owners[last];
+			if (owners[slot] != NULL) owners[slot]->storeSlot = slot;
+		}
+		// Padding lanes must stay still, kernels run over them.
+		xVel[last] = 0; yVel[last] = 0; zVel[last] = 0;
+		owners[last] = NULL;
+		count--;
+	}
+
+	void ElementStore::Clear(){
+		for (size_t i = 0; i < count; i++) {
+			if (owners[i] != NULL) owners[i]->store = NULL;
+			owners[i] = NULL;
+			xVel[i] = 0; yVel[i] = 0; zVel[i] = 0;
+		}
+		count = 0;
+	}
+
+	void ElementStore::Integrate(float dt){
+		Integrate(dt, 0, count);
+	}
+
+	void ElementStore::Integrate(float dt, size_t begin, size_t end){
+		// Xf = Xi + V*T, one vectorized pass per axis.
+		if (end > count) end = count;
+		if (begin >= end) return;
+		const size_t lanes = SimdRoundUp(end) - begin;
+		std::memcpy(xPrev.Data() + begin, xPos.Data() + begin, lanes * sizeof(float));
+		std::memcpy(yPrev.Data() + begin, yPos.Data() + begin, lanes * sizeof(float));
+		std::memcpy(zPrev.Data() + begin, zPos.Data() + begin, lanes * sizeof(float));
+		SimdMultiplyAdd(xPos.Data() + begin, xVel.Data() + begin, dt, lanes);
+		SimdMultiplyAdd(yPos.Data() + begin, yVel.Data() + begin, dt, lanes);
+		SimdMultiplyAdd(zPos.Data() + begin, zVel.Data() + begin, dt, lanes);
+	}
+
+	void ElementStore::PullOwners(){
+		for (size_t i = 0; i < count; i++) {
+			if (owners[i] != NULL) owners[i]->pullStep();
+		}
+	}
+}
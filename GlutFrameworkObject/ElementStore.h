@@ -0,0 +1,99 @@
+///////////////////////////////////////////////////////////////////////////////
+/// GlFrameworkBasic is free software : you can redistribute it and or modify
+/// it under the terms of the GNU General Public License as published by
+/// the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// GlFrameworkBasic is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with GlFrameworkBasic. If not, see <http://www.gnu.org/licenses/>.
+///
+/// Author: Evan Edstrom
+/// Date: 11/17/2013
+/// Website: http://evanedstrom.com/glstart
+/// Email: contact@evanedstrom.com
+///
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <vector>
+
+#include "Simd.h"
+
+namespace glFrameworkBasic {
+	class Element;
+
+	/**
+	* ElementStore keeps element state as structure-of-arrays: one contiguous,
+	* SIMD aligned array per component. Integrate() advances every position by
+	* its velocity in one vectorized pass instead of a virtual Move() call per
+	* element through a pointer.
+	* Slots are packed; removing one moves the last slot into the hole. An
+	* Element bound with Element::BindStore() tracks its slot automatically.
+	* Slots created with Add() directly have no owner and are only data.
+	*/
+	class ElementStore
+	{
+	public:
+		/// <summary>Creates an empty store.</summary>
+		ElementStore();
+
+		/// <summary>Destructor. Unbinds any Elements still using the store.</summary>
+		~ElementStore();
+
+		/// <summary>
+		/// Adds a slot at the origin, not moving, scale 1, shown.
+		/// Returns the slot index. owner may be NULL.
+		/// </summary>
+		unsigned int Add(Element *owner = NULL);
+
+		/// <summary>Removes a slot. The last slot is moved into its place.</summary>
+		void Remove(unsigned int slot);
+
+		/// <summary>Removes every slot and unbinds their owners.</summary>
+		void Clear();
+
+		/// <summary>Number of slots in use.</summary>
+		size_t Size() const { return count; }
+
+		/// <summary>Position += velocity * dt for every slot. The old position is kept in the Prev arrays.</summary>
+		void Integrate(float dt);
+
+		/// <summary>
+		/// Position += velocity * dt for slots [begin, end). begin must be a
+		/// multiple of SIMD_WIDTH; lets threads integrate disjoint ranges.
+		/// </summary>
+		void Integrate(float dt, size_t begin, size_t end);
+
+		/// <summary>
+		/// Copies position and the position before the last Integrate() into
+		/// every bound Element. Engine calls it once the steps that need the
+		/// elements' members are reached, not after every step.
+		/// </summary>
+		void PullOwners();
+
+		/// <summary>Element bound to a slot, or NULL for plain data slots.</summary>
+		Element *Owner(unsigned int slot) const { return owners[slot]; }
+
+		// Component arrays, valid for indices below Size().
+		AlignedFloatArray xPos, yPos, zPos;
+		AlignedFloatArray xVel, yVel, zVel;
+		AlignedFloatArray xScale, yScale, zScale;
+		AlignedFloatArray rotAngle;
+		std::vector<bool> show;
+		// Position before the last Integrate(), for render interpolation.
+		AlignedFloatArray xPrev, yPrev, zPrev;
+
+	private:
+		size_t count;
+		std::vector<Element *> owners;
+
+		// Copy is not allowed, owners point back at this store.
+		ElementStore(const ElementStore &);
+		ElementStore &operator=(const ElementStore &);
+	};
+}
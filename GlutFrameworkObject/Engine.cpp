@@ -20,40 +20,106 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include "Engine.h"
+#include "ShapeCache.h"
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <typeinfo>
 
 namespace glFrameworkBasic {
-	Engine *Engine::instance = NULL;
+	std::unordered_map<int, Engine *> Engine::windows;
+	std::vector<int> Engine::idleWindows;
+	std::vector<Engine::TimerSlot> Engine::timerSlots;
+
+	namespace {
+		bool glutStarted = false;	// glutInit() may only run once per process
+	}
 
 	Engine::Engine()
 	{
-		instance = this;
-
-		MatrixProjectionScale = 100.0;
-		WINDOW_WIDTH = 640;
-		WINDOW_HEIGHT = 480;
-		WINDOW_POS_X = 50;
-		WINDOW_POS_Y = 50;
-		DO_FULL_SCN = false;
-		windowTitle = "GLUT Framework Basic - By Evan Edstrom";
+		initDefaults(100.0);
 	}
 
 	Engine::Engine(float projectionScale)
 	{
-		instance = this;
+		initDefaults(projectionScale);
+	}
 
+	void Engine::initDefaults(float projectionScale){
 		MatrixProjectionScale = projectionScale;
+		viewportWidth = 0;
+		viewportHeight = 0;
+		pixelsPerUnit = 1.0f;
+		viewBounds = Aabb(-projectionScale, -projectionScale, projectionScale, projectionScale);
+		culling = true;
+		drawnCount = 0;
 		WINDOW_WIDTH = 640;
 		WINDOW_HEIGHT = 480;
 		WINDOW_POS_X = 50;
 		WINDOW_POS_Y = 50;
 		DO_FULL_SCN = false;
 		windowTitle = "GLUT Framework Basic - By Evan Edstrom";
+
+		backend = BACKEND_GLUT;
+		frameLimit = 0;
+		frameCount = 0;
+		stopRequested = false;
+		batching = false;
+		parallelUpdate = false;
+		updateGrainSize = 1024;
+		jobSystem = NULL;
+		broadphase = NULL;
+		storeStale = false;
+		profileElementTypes = false;
+		replaySteps = 0;
+		staticLayerEnabled = false;
+		typeSorted = false;
+		drawSorting = false;
+		commandBudget = 10000;
+		pipelined = false;
+		snapshotAlpha = 1.0f;
+		simulateSteps = 0;
+		simulateProfiler = NULL;
+		simulating = 0;
+		staticLayerDirty = true;
+		staticLayerActive = false;
+		redrawOnDemand = false;
+		redrawActive = true;
+		redrawRequested = true;
+		wasAnimating = false;
+		drawnItemCount = 0;
+		timerGeneration = 0;
+		freeHandle = ElementHandle::NULL_INDEX;
+		window = 0;
+		timerSlot = -1;
+
+		refreshMills = 30;
+		timestep = 0.030;
+		maxStepsPerFrame = 5;
+		accumulator = 0.0;
+		lastFrameTime = 0.0;
+		tickCount = 0;
+		interpolate = true;
+		interpolationAlpha = 1.0f;
 	}
 
 	Engine::~Engine() { 
+		// Later callbacks for the window find no engine and return. No GLUT
+		// calls here, the engine may outlive GLUT when destroyed at exit.
+		if (window != 0) windows.erase(window);
+		if (timerSlot >= 0) {
+			// Pending timers of ours stay stale for the slot's next owner.
+			timerSlots[timerSlot].engine = NULL;
+			timerSlots[timerSlot].generation = (timerGeneration + 1) & 0xfffff;
+		}
 		// Iterate all items and delete them.
 		for (std::vector<Element*>::iterator i = drawItems.begin(), e = drawItems.end(); i != e; ++i)
-			delete (*i);
+			destroyElement(*i);
+		for (std::unordered_map<std::type_index, ElementPoolBase *>::iterator i = pools.begin(); i != pools.end(); ++i)
+			delete i->second;	// After the elements living in them
+		delete jobSystem;	// Joins the worker threads.
+		delete broadphase;
 	}
 
 	void Engine::SetWindowSize(int w, int h){
@@ -70,17 +136,383 @@ namespace glFrameworkBasic {
 	void Engine::SetWindowTitle(std::string title){
 		windowTitle = title;
 	}
+	ElementHandle Engine::addSpawned(Element *element){
+		unsigned int index = freeHandle;
+		if (index == ElementHandle::NULL_INDEX) {
+			HandleSlot slot = { NULL, 0, 0, ElementHandle::NULL_INDEX, 0 };
+			index = (unsigned int)handleSlots.size();
+			handleSlots.push_back(slot);
+		}
+		else freeHandle = handleSlots[index].nextFree;
+
+		HandleSlot &slot = handleSlots[index];
+		slot.element = element;
+		slot.drawIndex = (unsigned int)drawItems.size();
+		slot.nextFree = ElementHandle::NULL_INDEX;
+		slot.ticket = 0;
+		element->handleIndex = index;
+		drawItems.push_back(element);
+		return ElementHandle(index, slot.generation);
+	}
+	void Engine::Despawn(ElementHandle handle){
+		if (IsAlive(handle)) pendingDespawns.push_back(handle);
+	}
+	bool Engine::Attach(Element *child, Element *parent){
+		return sceneGraph.Attach(child, parent);
+	}
+	bool Engine::Attach(ElementHandle child, ElementHandle parent){
+		if (!IsAlive(child) || !IsAlive(parent)) return false;
+		return sceneGraph.Attach(Get(child), Get(parent));
+	}
+	void Engine::Detach(Element *child){
+		sceneGraph.Detach(child);
+	}
+	CommandQueue &Engine::GetCommandQueue(){
+		return commands;
+	}
+	void Engine::SetCommandBudget(size_t n){
+		commandBudget = n;
+	}
+	void Engine::applyCommands(){
+		for (size_t n = 0; commandBudget == 0 || n < commandBudget; n++) {
+			CommandQueue::Command *command = commands.Pop();
+			if (command == NULL) break;
+
+			ElementHandle handle = command->handle;
+			if (command->ticket != 0 && command->type != CommandQueue::CREATE) {
+				std::unordered_map<CommandTicket, ElementHandle>::iterator i = commandElements.find(command->ticket);
+				handle = i != commandElements.end() ? i->second : ElementHandle();
+				if (command->type == CommandQueue::DESTROY && i != commandElements.end()) commandElements.erase(i);
+			}
+			switch (command->type) {
+			case CommandQueue::CREATE:
+				handle = command->create(*this);
+				if (IsAlive(handle)) {
+					commandElements[command->ticket] = handle;
+					handleSlots[handle.index].ticket = command->ticket;	// Forgotten when the element goes
+				}
+				break;
+			case CommandQueue::UPDATE:
+				if (Element *element = Get(handle)) command->update(*element);
+				break;
+			case CommandQueue::DESTROY:
+				Despawn(handle);
+				break;
+			}
+			delete command;
+		}
+	}
+	Element *Engine::Get(ElementHandle handle) const {
+		return IsAlive(handle) ? handleSlots[handle.index].element : NULL;
+	}
+	bool Engine::IsAlive(ElementHandle handle) const {
+		return handle.index < handleSlots.size()
+			&& handleSlots[handle.index].generation == handle.generation
+			&& handleSlots[handle.index].element != NULL;
+	}
+	void Engine::applyDespawns(){
+		for (size_t i = 0; i < pendingDespawns.size(); i++) {
+			const ElementHandle handle = pendingDespawns[i];
+			if (!IsAlive(handle)) continue;	// Despawned twice
+			HandleSlot &slot = handleSlots[handle.index];
+			Element *element = slot.element;
+
+			// drawIndex is only stale if drawItems was edited by hand.
+			unsigned int at = slot.drawIndex;
+			if (at >= drawItems.size() || drawItems[at] != element) {
+				for (at = 0; at < drawItems.size() && drawItems[at] != element; at++);
+			}
+			if (at < drawItems.size()) {
+				Element *last = drawItems.back();
+				drawItems[at] = last;
+				drawItems.pop_back();
+				if (last != element && last->handleIndex != ElementHandle::NULL_INDEX)
+					handleSlots[last->handleIndex].drawIndex = at;
+			}
+
+			if (element->isStatic) staticLayerDirty = true;
+			if (slot.ticket != 0) {
+				// However it was despawned, its ticket no longer resolves.
+				commandElements.erase(slot.ticket);
+				slot.ticket = 0;
+			}
+			destroyElement(element);
+			slot.element = NULL;
+			slot.generation++;
+			slot.nextFree = freeHandle;
+			freeHandle = handle.index;
+		}
+		pendingDespawns.clear();
+	}
+	void Engine::destroyElement(Element *element){
+		if (element->pool != NULL) element->pool->Release(element);
+		else delete element;
+	}
+	void Engine::SetBatching(bool doBatch){
+		batching = doBatch;
+	}
+	void Engine::SetParallelUpdate(bool doParallel){
+		parallelUpdate = doParallel;
+	}
+	void Engine::SetCulling(bool doCull){
+		culling = doCull;
+	}
+	unsigned int Engine::GetDrawnCount() const {
+		return drawnCount;
+	}
+	Profiler &Engine::GetProfiler(){
+		return profiler;
+	}
+	void Engine::SetProfileElementTypes(bool doProfile){
+		profileElementTypes = doProfile;
+	}
+	void Engine::SetTypeSorted(bool doSort){
+		typeSorted = doSort;
+	}
+	void Engine::SetInstancing(bool doInstance){
+		renderBatch.SetInstancing(doInstance);
+	}
+	void Engine::SetDrawSorting(bool doSort){
+		drawSorting = doSort;
+	}
+	void Engine::SetPipelined(bool doPipeline){
+		pipelined = doPipeline;
+	}
+	size_t Engine::unpooledCount() const {
+		size_t pooled = 0;
+		for (size_t g = 0; g < typeGroups.size(); g++) pooled += typeGroups[g].pool->Size();
+		return drawItems.size() - pooled;
+	}
+	void Engine::SetUpdateGrainSize(unsigned int elements){
+		updateGrainSize = elements < 1 ? 1 : elements;
+	}
+	JobSystem &Engine::Jobs(){
+		if (jobSystem == NULL) jobSystem = new JobSystem();
+		return *jobSystem;
+	}
+	void Engine::SetStaticLayer(bool doCache){
+		staticLayerEnabled = doCache;
+		staticLayerDirty = true;
+	}
+	void Engine::InvalidateStaticLayer(){
+		staticLayerDirty = true;
+	}
+	void Engine::SetBroadphase(Broadphase *phase){
+		if (phase == broadphase) return;
+		delete broadphase;
+		broadphase = phase;
+	}
+	void Engine::SetTimestep(double seconds){
+		if (seconds > 0.0) timestep = seconds;
+	}
+	void Engine::SetMaxStepsPerFrame(int steps){
+		maxStepsPerFrame = steps < 1 ? 1 : steps;
+	}
+	void Engine::SetInterpolation(bool doInterpolate){
+		interpolate = doInterpolate;
+	}
+	void Engine::SetFrameRate(double framesPerSecond){
+		if (framesPerSecond <= 0.0) refreshMills = 0;
+		else {
+			refreshMills = (int)(1000.0 / framesPerSecond + 0.5);
+			if (refreshMills < 1) refreshMills = 1;
+		}
+	}
+	void Engine::SetRedrawOnDemand(bool onDemand){
+		redrawOnDemand = onDemand;
+		if (!onDemand) RequestRedraw();	// Restart the normal frame loop if idle
+	}
+	void Engine::RequestRedraw(){
+		redrawRequested = true;
+		if (!redrawActive) wakeRedraw();
+	}
+	bool Engine::anyElementDirty() const {
+		for (size_t i = 0; i < drawItems.size(); i++) {
+			if (drawItems[i]->dirty) return true;
+		}
+		return false;
+	}
+	bool Engine::sceneChanging(){
+		bool animating = false;
+		bool changed = redrawRequested || drawItems.size() != drawnItemCount || !commands.Empty();
+		for (size_t i = 0; i < drawItems.size(); i++) {
+			Element *item = drawItems[i];
+			if (item->dirty) {
+				changed = true;
+				item->dirty = false;	// Drawn this frame
+			}
+			if (!animating && item->IsAnimating()) animating = true;
+		}
+		if (particles.IsAnimating()) animating = true;
+		// One more frame after motion stops so interpolation settles.
+		const bool more = changed || animating || wasAnimating;
+		wasAnimating = animating;
+		redrawRequested = false;
+		drawnItemCount = drawItems.size();
+		return more;
+	}
+	void Engine::wakeRedraw(){
+		redrawActive = true;
+		lastFrameTime = frameClock.Seconds();	// Idle time is not simulation time
+		timerGeneration++;						// Ends the idle poll chain
+		if (refreshMills > 0) startTimer(0);
+		else updateIdleFunc();
+	}
+	void Engine::sleepRedraw(){
+		redrawActive = false;
+		if (refreshMills > 0) return;	// The running timer chain switches to polling
+		updateIdleFunc();
+		timerGeneration++;
+		startTimer(IDLE_POLL_MILLS);
+	}
+	unsigned long long Engine::GetTickCount() const {
+		return tickCount;
+	}
+	void Engine::SetBackend(Backend b){
+		backend = b;
+	}
+	void Engine::SetFrameLimit(unsigned int frames){
+		frameLimit = frames;
+	}
+	void Engine::Stop(){
+		stopRequested = true;
+	}
+	bool Engine::RecordInput(const std::string &path){
+		return inputLog.OpenWrite(path, timestep);
+	}
+	bool Engine::StartCapture(const std::string &path, unsigned int everyNth){
+		const bool y4m = path.size() >= 4 && path.compare(path.size() - 4, 4, ".y4m") == 0;
+		if (everyNth == 0) everyNth = 1;
+		// Y4M frame rate: the display rate, or one frame per update step when unlimited.
+		unsigned int numerator = 1000, denominator = (unsigned int)refreshMills * everyNth;
+		if (refreshMills == 0) {
+			numerator = 1000000;
+			denominator = (unsigned int)(timestep * 1000000.0 + 0.5) * everyNth;
+		}
+		return frameCapture.Start(path, y4m ? FrameCapture::FORMAT_Y4M : FrameCapture::FORMAT_RAW,
+			everyNth, numerator, denominator);
+	}
+	void Engine::StopCapture(){
+		frameCapture.Stop();
+	}
+	void Engine::SetAllocationTracking(bool doTrack){
+		allocations.SetEnabled(doTrack);
+		if (doTrack && !AllocationTracker::IsCompiledIn())
+			std::cerr << "Allocation tracking needs a build with GLFRAMEWORK_TRACK_ALLOCATIONS" << std::endl;
+	}
+	void Engine::SetAllocationGuard(unsigned int warmupFrames){
+		if (warmupFrames > 0) SetAllocationTracking(true);
+		allocations.SetGuard(warmupFrames);
+	}
+	bool Engine::ReplayInput(const std::string &path){
+		if (!inputLog.OpenRead(path)) return false;
+		SetTimestep(inputLog.Timestep());
+		return true;
+	}
+	unsigned long long Engine::GetStateChecksum() const {
+		// FNV-1a over the raw bits, so any difference at all shows.
+		unsigned long long hash = 14695981039346656037ULL;
+		struct Hasher {
+			static void bytes(unsigned long long &h, const void *data, size_t size){
+				const unsigned char *p = (const unsigned char *)data;
+				for (size_t i = 0; i < size; i++) {
+					h ^= p[i];
+					h *= 1099511628211ULL;
+				}
+			}
+		};
+		Hasher::bytes(hash, &tickCount, sizeof(tickCount));
+		const unsigned int count = (unsigned int)drawItems.size();
+		Hasher::bytes(hash, &count, sizeof(count));
+		for (unsigned int i = 0; i < count; i++) {
+			const Element *e = drawItems[i];
+			const float state[] = { e->xPos, e->yPos, e->zPos, e->xVel, e->yVel, e->zVel,
+				e->xScale, e->yScale, e->zScale, e->rotAngle };
+			Hasher::bytes(hash, state, sizeof(state));
+			const unsigned char shown = e->show ? 1 : 0;
+			Hasher::bytes(hash, &shown, 1);
+		}
+		const unsigned int particleCount = (unsigned int)particles.Size();
+		Hasher::bytes(hash, &particleCount, sizeof(particleCount));
+		if (particleCount > 0) {
+			Hasher::bytes(hash, particles.xPos.Data(), particleCount * sizeof(float));
+			Hasher::bytes(hash, particles.yPos.Data(), particleCount * sizeof(float));
+		}
+		return hash;
+	}
+	ParticleSystem &Engine::GetParticles(){
+		return particles;
+	}
+	const Input &Engine::GetInput() const {
+		return input;
+	}
+	unsigned int Engine::GetFrameCount() const {
+		return frameCount;
+	}
+	const std::vector<unsigned char> &Engine::GetFramebuffer(){
+		return headlessContext.ReadFramebuffer();
+	}
+	bool Engine::HasGLContext() const {
+		return backend == BACKEND_GLUT || headlessContext.IsCreated();
+	}
 
 	void Engine::Begin(int argc, char **argv)
 	{
-		glutInit(&argc, argv);
-		glutInitDisplayMode(GLUT_DOUBLE);  // Enable double buffered mode
+		for (int i = 1; i < argc; i++) {
+			if (strcmp(argv[i], "--headless") == 0) backend = BACKEND_HEADLESS;
+			else if (strcmp(argv[i], "--profile") == 0) profiler.SetEnabled(true);
+			else if (strcmp(argv[i], "--allocations") == 0) SetAllocationTracking(true);
+			else if (strcmp(argv[i], "--allocation-guard") == 0 && i + 1 < argc)
+				SetAllocationGuard((unsigned int)atoi(argv[++i]));
+			else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+				if (!RecordInput(argv[++i])) std::cerr << "Cannot record input to " << argv[i] << std::endl;
+			}
+			else if (strcmp(argv[i], "--capture") == 0 && i + 1 < argc) {
+				if (!StartCapture(argv[++i])) std::cerr << "Cannot capture frames to " << argv[i] << std::endl;
+			}
+			else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+				if (!ReplayInput(argv[++i])) std::cerr << "Cannot replay input from " << argv[i] << std::endl;
+			}
+		}
+		if (inputLog.IsReading()) backend = BACKEND_HEADLESS;	// Replays run at full speed
+		frameCount = 0;
+		stopRequested = false;
+		tickCount = 0;
+		accumulator = 0.0;
+		frameClock.Reset();
+		lastFrameTime = 0.0;
+
+		if (backend == BACKEND_HEADLESS) {
+			runHeadless();	// Returns once the frame limit is hit or Stop() is called.
+			if (inputLog.IsReading()) {
+				inputLog.Close();
+				std::cout << "Replayed " << frameCount << " frames, " << tickCount
+					<< " ticks, checksum " << std::hex << GetStateChecksum() << std::dec << std::endl;
+			}
+			return;
+		}
+
+		OpenWindow(argc, argv);
+		glutMainLoop();	// Enter the infinite event-processing loop
+	}
+
+	void Engine::OpenWindow(int argc, char **argv){
+		if (!glutStarted) {
+			glutInit(&argc, argv);
+			glutInitDisplayMode(GLUT_DOUBLE);  // Enable double buffered mode
+			glutStarted = true;
+		}
 		
 		generateWindow();	// Make OpenGL window (either full screen or window).
+		window = glutGetWindow();
+		windows[window] = this;
+		if (timerSlot < 0 && !acquireTimerSlot())
+			std::cerr << "More than " << TIMER_SLOTS << " engine windows, frames of this one are not timed" << std::endl;
 
 		// Register interaction type event handlers.
 		glutMouseFunc(mousePressWrapper);
 		glutMotionFunc(mouseMoveWrapper);
+		glutPassiveMotionFunc(passiveMouseMoveWrapper);
 		glutKeyboardFunc(keyboardDownWrapper);
 		glutKeyboardUpFunc(keyboardUpWrapper);
 		glutSpecialFunc(specialKeyboardDownWrapper);
@@ -88,11 +520,30 @@ namespace glFrameworkBasic {
 
 		glutDisplayFunc(displayWrapper);	// Register callback handler for window re-paint event
 		glutReshapeFunc(reshapeWrapper);	// Register callback handler for window re-size event
-		glutTimerFunc(0, timer, 0);			// First timer call immediately
+		redrawActive = true;
+		if (refreshMills > 0)
+			startTimer(0);	// First timer call immediately
+		else
+			updateIdleFunc();		// Uncapped, redisplay whenever idle
 		
 		initGL();		// Our own OpenGL initialization
 		setup();		// Any user defined setup that needs to happen.
-		glutMainLoop();	// Enter the infinite event-processing loop
+	}
+
+	void Engine::runHeadless(){
+		// Without an offscreen provider the loop still runs; GL calls are
+		// simply dropped because no context is current.
+		headlessContext.Create(WINDOW_WIDTH, WINDOW_HEIGHT);
+
+		initGL();
+		reshape(WINDOW_WIDTH, WINDOW_HEIGHT);
+		setup();
+
+		while (!stopRequested && (frameLimit == 0 || frameCount < frameLimit))
+			runFrame();
+
+		StopCapture();	// Reads the last frames while the context exists
+		headlessContext.Finish();
 	}
 
 	void Engine::initGL(){
@@ -107,23 +558,395 @@ namespace glFrameworkBasic {
 		glClear(GL_COLOR_BUFFER_BIT);   // Clear the color buffer
 		glMatrixMode(GL_MODELVIEW);     // To operate on Model-View matrix
 		glLoadIdentity();               // Reset the model-view matrix
+		ShapeCache::SetPixelsPerUnit(pixelsPerUnit);	// Level of detail for this frame
+		drawStatic();		// Cached background under everything else
+		const int steps = advanceClock();
 		
-		// Call the pre display loop:
-		preDisplayLoop();
+		{
+			GLFRAMEWORK_PROFILE_SCOPE("commands");
+			applyCommands();
+		}
 
-		// Do the loop
-		for (unsigned int i = 0; i < drawItems.size(); i++)
+		// Call the pre display loop:
 		{
-			drawItems.at(i)->Move();
-			drawItems.at(i)->BeforeDraw();
-			drawItems.at(i)->Draw();
-			drawItems.at(i)->AfterDraw();
+			GLFRAMEWORK_PROFILE_SCOPE("preDisplayLoop");
+			preDisplayLoop();
+			applyDespawns();
+		}
+
+		sceneGraph.Update();	// Changes made outside the update steps
+		if (pipelined) {
+			// Draw the state the last frame simulated while a job runs this
+			// frame's steps. Interpolation keeps the last frame's alpha, so
+			// the picture matches the unpipelined one a frame later.
+			{
+				GLFRAMEWORK_PROFILE_SCOPE("snapshot");
+				captureSnapshot(snapshotAlpha);
+				snapshotAlpha = interpolationAlpha;
+			}
+			JobSystem &jobs = Jobs();
+			simulateSteps = steps;
+			simulateProfiler = Profiler::Current();
+			simulating = 1;
+			jobs.Schedule(simulateJob, this);
+			{
+				GLFRAMEWORK_PROFILE_SCOPE("draw");
+				drawSnapshot();
+			}
+			{
+				GLFRAMEWORK_PROFILE_SCOPE("fence");
+				jobs.WaitFor(simulating);
+				applyDespawns();
+			}
+		}
+		else {
+			// Do the loop: fixed timestep updates, then one draw pass.
+			simulate(steps, true);
+			GLFRAMEWORK_PROFILE_SCOPE("draw");
+			drawElements();
+			particles.Prepare((float)((interpolationAlpha - 1.0f) * timestep), parallelUpdate ? &Jobs() : NULL);
+			particles.Render();
 		}
 
 		// Call the post display loop:
-		postDisplayLoop();
+		{
+			GLFRAMEWORK_PROFILE_SCOPE("postDisplayLoop");
+			postDisplayLoop();
+			applyDespawns();
+		}
+
+		if (frameCapture.IsActive()) {
+			GLFRAMEWORK_PROFILE_SCOPE("capture");
+			frameCapture.Capture(viewportWidth, viewportHeight);
+		}
+
+		GLFRAMEWORK_PROFILE_SCOPE("swapBuffers");
+		swapBuffers();   // Double buffered - swap the front and back buffers
+	}
+
+	void Engine::runFrame(){
+		Profiler::SetCurrent(&profiler);
+		if (inputLog.IsReading()) {
+			// Feed the frame's recorded input, the clock uses its step count.
+			if (!inputLog.ReadFrame(replayEvents, replaySteps)) {
+				stopRequested = true;
+				return;
+			}
+			for (size_t i = 0; i < replayEvents.size(); i++)
+				dispatchInput(replayEvents[i]);
+		}
+		AllocationTracker::SetCurrent(&allocations);
+		allocations.BeginFrame();
+		frameArena.Reset();
+		input.BeginFrame();	// Everything queued since the last frame
+		{
+			GLFRAMEWORK_PROFILE_SCOPE("frame");
+			display();
+		}
+		allocations.EndFrame();
+		AllocationTracker::SetCurrent(NULL);	// Only frames are counted
+		frameCount++;
+		if (profiler.IsEnabled()) profiler.EndFrame();
+	}
+
+	int Engine::advanceClock(){
+		if (inputLog.IsReading()) {
+			// Replay runs exactly the recorded steps.
+			tickCount += replaySteps;
+			interpolationAlpha = 1.0f;
+			return replaySteps;
+		}
+
+		// Headless frames are exactly one step so runs are reproducible.
+		const double now = frameClock.Seconds();
+		const double frameTime = backend == BACKEND_HEADLESS ? timestep : now - lastFrameTime;
+		lastFrameTime = now;
+
+		accumulator += frameTime;
+		int steps = (int)(accumulator / timestep);
+		if (steps > maxStepsPerFrame) {
+			// Too far behind, drop the backlog instead of spiraling.
+			steps = maxStepsPerFrame;
+			accumulator = fmod(accumulator, timestep);
+		}
+		else accumulator -= steps * timestep;
+		tickCount += steps;
+		inputLog.WriteFrame(steps);	// No-op unless recording
+
+		if (interpolate && backend != BACKEND_HEADLESS)
+			interpolationAlpha = (float)(accumulator / timestep);
+		else
+			interpolationAlpha = 1.0f;
+		return steps;
+	}
+
+	void Engine::updateElements(){
+		const bool grouped = typeSorted && !typeGroups.empty();
+		const bool unpooled = grouped && unpooledCount() > 0;
+		if (!parallelUpdate) {
+			// Move every store-bound element at once.
+			elementStore.Integrate(1.0f);
+			storeStale = elementStore.Size() > 0;
 
-		glutSwapBuffers();   // Double buffered - swap the front and back buffers
+			// Counts are taken once: elements spawned by Move() wait for the next step.
+			const size_t count = drawItems.size();
+			if (!grouped) {
+				updateRange<VirtualDispatch>(drawItems, 0, count);
+				return;
+			}
+			const size_t groups = typeGroups.size();
+			for (size_t g = 0; g < groups; g++) {
+				const TypeGroup group = typeGroups[g];	// Copied, a new type grows typeGroups
+				group.update(*this, *group.pool, 0, group.pool->Size());
+			}
+			for (size_t i = 0; unpooled && i < count; i++) {
+				if (drawItems[i]->pool == NULL) updateRange<VirtualDispatch>(drawItems, i, i + 1);
+			}
+			return;
+		}
+
+		// Same work split into chunks. Store chunks stay SIMD aligned.
+		// Workers record into this engine's profiler too.
+		JobSystem &jobs = Jobs();
+		ElementStore &store = elementStore;
+		Profiler *current = Profiler::Current();
+		const size_t storeGrain = SimdRoundUp(updateGrainSize * 4);
+		jobs.ParallelFor(store.Size(), storeGrain, [&store, current](size_t begin, size_t end) {
+			Profiler::SetCurrent(current);
+			GLFRAMEWORK_PROFILE_SCOPE("update.store");
+			store.Integrate(1.0f, begin, end);
+		});
+		storeStale = store.Size() > 0;
+
+		Engine &engine = *this;
+		if (grouped) {
+			for (size_t g = 0; g < typeGroups.size(); g++) {
+				const TypeGroup &group = typeGroups[g];
+				jobs.ParallelFor(group.pool->Size(), updateGrainSize, [&engine, &group, current](size_t begin, size_t end) {
+					Profiler::SetCurrent(current);
+					GLFRAMEWORK_PROFILE_SCOPE("update.move");
+					group.update(engine, *group.pool, begin, end);
+				});
+			}
+			if (!unpooled) return;
+		}
+
+		std::vector<Element *> &items = drawItems;
+		jobs.ParallelFor(items.size(), updateGrainSize, [&items, grouped, current](size_t begin, size_t end) {
+			Profiler::SetCurrent(current);
+			GLFRAMEWORK_PROFILE_SCOPE("update.move");
+			for (size_t i = begin; i < end; i++) {
+				if (grouped && items[i]->pool != NULL) continue;	// Done by its type group
+				updateRange<VirtualDispatch>(items, i, i + 1);
+			}
+		});
+	}
+
+	void Engine::syncStore(){
+		if (!storeStale) return;
+		GLFRAMEWORK_PROFILE_SCOPE("update.sync");
+		elementStore.PullOwners();
+		storeStale = false;
+	}
+
+	void Engine::findCollisions(){
+		if (broadphase == NULL) return;
+		broadphase->Update(drawItems);
+		broadphase->FindPairs(collisionPairs);
+		for (size_t i = 0; i < collisionPairs.size(); i++)
+			collide(collisionPairs[i].a, collisionPairs[i].b);
+	}
+
+	void Engine::drawStatic(){
+		staticLayerActive = false;
+		if (!staticLayerEnabled || !staticLayer.IsSupported()) {
+			drawStaticLayer();	// Static elements stay in the normal pass
+			return;
+		}
+
+		bool stale = staticLayerDirty || !staticLayer.IsValid(viewportWidth, viewportHeight);
+		for (size_t i = 0; i < drawItems.size(); i++) {
+			Element *item = drawItems[i];
+			if (item->isStatic && item->layerDirty) {
+				stale = true;
+				item->layerDirty = false;
+			}
+		}
+
+		if (stale) {
+			GLFRAMEWORK_PROFILE_SCOPE("staticLayer");
+			if (!staticLayer.BeginRender(viewportWidth, viewportHeight)) {
+				drawStaticLayer();
+				return;
+			}
+			drawStaticLayer();
+			drawElements(true);
+			staticLayer.EndRender();
+			staticLayerDirty = false;
+		}
+		staticLayer.Composite();
+		staticLayerActive = true;
+	}
+
+	void Engine::drawStaticLayer(){
+		// Implement in derived class.
+	}
+
+	void Engine::drawElements(bool staticPass){
+		DrawState state;
+		state.blend = !staticPass && interpolationAlpha < 1.0f;
+		state.alpha = interpolationAlpha;
+		state.cull = culling;
+		state.view = viewBounds;
+		state.staticPass = staticPass;
+		state.skipStatic = staticLayerActive;
+		// Per type timing: one sample per run of same-typed elements.
+		state.timeTypes = profileElementTypes && profiler.IsEnabled();
+		state.runType = NULL;
+		state.runStart = 0;
+		state.drawn = 0;
+
+		if (batching) renderBatch.Begin();
+		if (drawSorting) {
+			sortDrawItems();
+			Element *const *items = renderQueue.Sorted();
+			const size_t count = renderQueue.Size();
+			if (typeSorted && !typeGroups.empty()) {
+				// Keys keep each type together, draw every run with its typed loop.
+				size_t start = 0;
+				while (start < count) {
+					ElementPoolBase *pool = items[start]->pool;
+					size_t end = start + 1;
+					while (end < count && items[end]->pool == pool) end++;
+					if (pool != NULL) typeGroups[pool->typeIndex - 1].drawSorted(*this, items, start, end, state);
+					else drawRange<VirtualDispatch>(items, start, end, state);
+					start = end;
+				}
+			}
+			else drawRange<VirtualDispatch>(items, 0, count, state);
+		}
+		else if (typeSorted && !typeGroups.empty()) {
+			const size_t groups = typeGroups.size();
+			for (size_t g = 0; g < groups; g++) {
+				const TypeGroup group = typeGroups[g];	// Copied, a new type grows typeGroups
+				group.draw(*this, *group.pool, 0, group.pool->Size(), state);
+			}
+			if (unpooledCount() > 0) {
+				const size_t count = drawItems.size();
+				for (size_t i = 0; i < count; i++) {
+					if (drawItems[i]->pool == NULL) drawRange<VirtualDispatch>(drawItems, i, i + 1, state);
+				}
+			}
+		}
+		else drawRange<VirtualDispatch>(drawItems, 0, drawItems.size(), state);
+		if (batching) renderBatch.Flush();
+		if (state.runType != NULL) profiler.Record(state.runType, state.runStart, Clock::Ticks());	// Includes the final flush
+		if (!staticPass) drawnCount = state.drawn;
+	}
+
+	void Engine::sortDrawItems(){
+		renderQueue.Begin();
+		for (size_t i = 0; i < drawItems.size(); i++) {
+			Element *item = drawItems[i];
+			if (!item->IsShown()) continue;
+			const float depth = item->parent != NULL ? item->GetWorldTransform().z : item->zPos;
+			const unsigned int type = item->pool != NULL ? item->pool->typeIndex : 0;
+			renderQueue.Add(RenderQueue::MakeKey(item->drawLayer, depth, type, item->GetMaterialId()), item);
+		}
+		renderQueue.Sort();
+	}
+
+	void Engine::simulate(int steps, bool applyEachStep){
+		for (int s = 0; s < steps; s++) {
+			{
+				GLFRAMEWORK_PROFILE_SCOPE("update");
+				updateElements();
+				if (sceneGraph.Size() > 0 || broadphase != NULL) syncStore();	// Both read positions
+				sceneGraph.Update();
+			}
+			if (particles.Size() > 0 || particles.EmitterCount() > 0) {
+				GLFRAMEWORK_PROFILE_SCOPE("particles");
+				particles.Update((float)timestep, parallelUpdate ? &Jobs() : NULL);
+			}
+			GLFRAMEWORK_PROFILE_SCOPE("collide");
+			findCollisions();
+			if (applyEachStep) applyDespawns();
+		}
+		syncStore();
+	}
+
+	void Engine::captureSnapshot(float alpha){
+		const bool blend = alpha < 1.0f;
+		snapshot.clear();
+		size_t count = drawItems.size();
+		if (drawSorting) {
+			sortDrawItems();
+			count = renderQueue.Size();
+		}
+		for (size_t i = 0; i < count; i++) {
+			// Indexed each time, BeforeDraw() may Spawn() and grow drawItems.
+			Element *item = drawSorting ? renderQueue.Sorted()[i] : drawItems[i];
+			if (!item->IsShown() || (item->isStatic && staticLayerActive)) continue;
+			if (blend) item->BeginInterpolation(alpha);
+			const bool attached = item->parent != NULL;
+			Transform parentWorld;
+			if (attached) parentWorld = sceneGraph.ParentWorld(item, alpha);
+			if (!culling || viewBounds.Overlaps(attached ? item->GetBounds().Transformed(parentWorld) : item->GetBounds())) {
+				item->BeforeDraw();
+				SnapshotItem entry = { item, attached ? parentWorld * item->GetTransform() : item->GetTransform(),
+					item->xPos, item->yPos, item->zPos, item->rotAngle,
+					item->xScale, item->yScale, item->zScale, attached, parentWorld };
+				snapshot.push_back(entry);
+				item->AfterDraw();
+			}
+			if (blend) item->EndInterpolation();
+		}
+		particles.Prepare((float)((alpha - 1.0f) * timestep), parallelUpdate ? &Jobs() : NULL);	// Quads are the particles' snapshot
+	}
+
+	void Engine::simulateJob(void *engine){
+		Engine &self = *(Engine *)engine;
+		Profiler::SetCurrent(self.simulateProfiler);
+		self.simulate(self.simulateSteps, false);
+		self.simulating--;
+	}
+
+	void Engine::drawSnapshot(){
+		renderBatch.Begin();
+		for (size_t i = 0; i < snapshot.size(); i++) {
+			SnapshotItem &entry = snapshot[i];
+			renderBatch.SetTransform(entry.transform);
+			if (entry.element->Submit(renderBatch)) continue;
+
+			// Draw() reads the members, so the simulation must be done first.
+			renderBatch.Flush();
+			Jobs().WaitFor(simulating);
+			Element *item = entry.element;
+			std::swap(item->xPos, entry.xPos);
+			std::swap(item->yPos, entry.yPos);
+			std::swap(item->zPos, entry.zPos);
+			std::swap(item->rotAngle, entry.rotAngle);
+			std::swap(item->xScale, entry.xScale);
+			std::swap(item->yScale, entry.yScale);
+			std::swap(item->zScale, entry.zScale);
+			if (entry.attached) drawAttached<VirtualDispatch>(item, true, entry.parentWorld);
+			else item->Draw();
+			std::swap(item->xPos, entry.xPos);
+			std::swap(item->yPos, entry.yPos);
+			std::swap(item->zPos, entry.zPos);
+			std::swap(item->rotAngle, entry.rotAngle);
+			std::swap(item->xScale, entry.xScale);
+			std::swap(item->yScale, entry.yScale);
+			std::swap(item->zScale, entry.zScale);
+		}
+		renderBatch.Flush();
+		particles.Render();
+		drawnCount = (unsigned int)snapshot.size();
+	}
+
+	void Engine::swapBuffers(){
+		if (backend == BACKEND_HEADLESS) glFlush();	// Offscreen, nothing to swap
+		else glutSwapBuffers();
 	}
 
 	void Engine::preDisplayLoop(){
@@ -134,6 +957,10 @@ namespace glFrameworkBasic {
 		// Implement in derived class.
 	}
 
+	void Engine::collide(Element * /*a*/, Element * /*b*/){
+		// Implement in derived class.
+	}
+
 	void Engine::reshape(GLsizei width, GLsizei height){
 		// Compute aspect ratio of the new window
 		if (height == 0) height = 1;	// To prevent divide by 0
@@ -141,10 +968,20 @@ namespace glFrameworkBasic {
 
 		// Set the viewport to cover the new window
 		glViewport(0, 0, width, height);
+		staticLayer.Invalidate();
+		viewportWidth = width;
+		viewportHeight = height;
+
+		// The shorter side spans 2 * MatrixProjectionScale world units.
+		pixelsPerUnit = (GLfloat)(width < height ? width : height) / (2.0f * MatrixProjectionScale);
+		ShapeCache::SetPixelsPerUnit(pixelsPerUnit);
 
 		// Set the aspect ratio of the clipping area to match the viewport
 		glMatrixMode(GL_PROJECTION);  // To operate on the Projection matrix
 		glLoadIdentity();
+		const float halfW = width >= height ? MatrixProjectionScale * aspect : MatrixProjectionScale;
+		const float halfH = width >= height ? MatrixProjectionScale : MatrixProjectionScale / aspect;
+		viewBounds = Aabb(-halfW, -halfH, halfW, halfH);	// Drawing starts from an identity model-view
 		if (width >= height) {
 			// aspect >= 1, set the height from -1 to 1, with larger width
 			gluOrtho2D(-1 * MatrixProjectionScale * aspect,
@@ -165,8 +1002,66 @@ namespace glFrameworkBasic {
 	}
 
 	void Engine::timer(int value){
+		Engine *engine = forTimer(value);
+		if (engine == NULL || value != engine->timerValue()) return;	// Closed, or replaced by a newer chain
+		glutSetWindow(engine->window);	// Timers run with no particular window current
+		if (!engine->redrawActive) {
+			// Idle: only look for changes made outside of input callbacks.
+			if (engine->anyElementDirty() || !engine->commands.Empty() || engine->particles.IsAnimating())
+				engine->wakeRedraw();
+			else glutTimerFunc(IDLE_POLL_MILLS, timer, value);
+			return;
+		}
 		glutPostRedisplay();      // Post re-paint request to activate display()
-		glutTimerFunc(refreshMills, timer, 0); // next Timer call milliseconds later
+		if (engine->refreshMills > 0)
+			glutTimerFunc(engine->refreshMills, timer, value); // next Timer call milliseconds later
+	}
+
+	int Engine::timerValue() const {
+		// Generation wraps well before value would overflow.
+		return (timerGeneration & 0xfffff) * TIMER_SLOTS + timerSlot;
+	}
+
+	void Engine::startTimer(unsigned int millis){
+		if (timerSlot >= 0) glutTimerFunc(millis, timer, timerValue());
+	}
+
+	Engine *Engine::forTimer(int value){
+		const size_t slot = (size_t)(value % TIMER_SLOTS);
+		return slot < timerSlots.size() ? timerSlots[slot].engine : NULL;
+	}
+
+	bool Engine::acquireTimerSlot(){
+		size_t slot = 0;
+		while (slot < timerSlots.size() && timerSlots[slot].engine != NULL) slot++;
+		if (slot == timerSlots.size()) {
+			if (slot == (size_t)TIMER_SLOTS) return false;
+			TimerSlot fresh = { NULL, 0 };
+			timerSlots.push_back(fresh);
+		}
+		timerSlots[slot].engine = this;
+		timerGeneration = timerSlots[slot].generation;
+		timerSlot = (int)slot;
+		return true;
+	}
+
+	Engine *Engine::forWindow(int id){
+		std::unordered_map<int, Engine *>::iterator i = windows.find(id);
+		return i != windows.end() ? i->second : NULL;
+	}
+
+	Engine *Engine::current(){
+		return forWindow(glutGetWindow());
+	}
+
+	void Engine::updateIdleFunc(){
+		for (std::unordered_map<int, Engine *>::iterator i = windows.begin(); i != windows.end(); ++i) {
+			if (i->second->refreshMills <= 0 && i->second->redrawActive) {
+				glutIdleFunc(idleWrapper);
+				return;
+			}
+		}
+		glutIdleFunc(NULL);
 	}
 
 	void Engine::mousePressFunc(int button, int state, int x, int y){
@@ -201,7 +1096,8 @@ namespace glFrameworkBasic {
 	std::string Engine::getWindowString(){
 		std::stringstream render;
 		render << glutGet(GLUT_SCREEN_WIDTH) << "x" <<
-			glutGet(GLUT_SCREEN_HEIGHT) << ":16@" << refreshMills;
+			glutGet(GLUT_SCREEN_HEIGHT) << ":16";
+		if (refreshMills > 0) render << "@" << refreshMills;	// Uncapped leaves the mode's own rate
 
 		return render.str();
 	}
@@ -219,34 +1115,83 @@ namespace glFrameworkBasic {
 	}
 
 	void Engine::displayWrapper(){
-		instance->display();
+		Engine *engine = current();
+		if (engine == NULL) return;
+		engine->runFrame();
+		if (engine->redrawOnDemand && engine->redrawActive && !engine->sceneChanging())
+			engine->sleepRedraw();
+	}
+
+	void Engine::idleWrapper(){
+		// One idle callback for every window; a copy survives engines closing.
+		// The buffer is kept, so only a new peak window count allocates.
+		std::vector<int> &ids = idleWindows;
+		ids.clear();
+		for (std::unordered_map<int, Engine *>::iterator i = windows.begin(); i != windows.end(); ++i) {
+			if (i->second->refreshMills <= 0 && i->second->redrawActive) ids.push_back(i->first);
+		}
+		for (size_t i = 0; i < ids.size(); i++) {
+			Engine *engine = forWindow(ids[i]);
+			if (engine == NULL) continue;
+			glutSetWindow(ids[i]);
+			engine->idle();
+		}
 	}
 
 	void Engine::reshapeWrapper(GLsizei width, GLsizei height){
-		instance->reshape(width, height);
+		Engine *engine = current();
+		if (engine == NULL) return;
+		engine->reshape(width, height);
+		engine->RequestRedraw();
+	}
+
+	void Engine::dispatchInput(const InputLogEvent &event){
+		if (backend == BACKEND_GLUT) RequestRedraw();
+		inputLog.WriteEvent(event);	// No-op unless recording
+		input.Push(event.type, event.code, event.x, event.y);
+		switch (event.type) {
+		case InputEvent::KEY_DOWN: keyboardDown((unsigned char)event.code, event.x, event.y); break;
+		case InputEvent::KEY_UP: keyboardUp((unsigned char)event.code, event.x, event.y); break;
+		case InputEvent::SPECIAL_DOWN: specialKeyboardDown(event.code, event.x, event.y); break;
+		case InputEvent::SPECIAL_UP: specialKeyboardUp(event.code, event.x, event.y); break;
+		case InputEvent::MOUSE_DOWN: mousePressFunc(event.code, GLUT_DOWN, event.x, event.y); break;
+		case InputEvent::MOUSE_UP: mousePressFunc(event.code, GLUT_UP, event.x, event.y); break;
+		case InputEvent::MOUSE_MOVE: if (event.drag) mouseMoveFunc(event.x, event.y); break;
+		}
 	}
 
 	void Engine::mousePressWrapper(int button, int state, int x, int y){
-		instance->mousePressFunc(button, state, x, y);
+		InputLogEvent event = { state == GLUT_DOWN ? InputEvent::MOUSE_DOWN : InputEvent::MOUSE_UP, false, button, x, y };
+		if (Engine *engine = current()) engine->dispatchInput(event);
 	}
 
 	void Engine::mouseMoveWrapper(int x, int y){
-		instance->mouseMoveFunc(x, y);
+		InputLogEvent event = { InputEvent::MOUSE_MOVE, true, 0, x, y };
+		if (Engine *engine = current()) engine->dispatchInput(event);
+	}
+
+	void Engine::passiveMouseMoveWrapper(int x, int y){
+		InputLogEvent event = { InputEvent::MOUSE_MOVE, false, 0, x, y };
+		if (Engine *engine = current()) engine->dispatchInput(event);
 	}
 
 	void Engine::keyboardUpWrapper(unsigned char key, int x, int y){
-		instance->keyboardUp(key, x, y);
+		InputLogEvent event = { InputEvent::KEY_UP, false, key, x, y };
+		if (Engine *engine = current()) engine->dispatchInput(event);
 	}
 
 	void Engine::keyboardDownWrapper(unsigned char key, int x, int y){
-		instance->keyboardDown(key, x, y);
+		InputLogEvent event = { InputEvent::KEY_DOWN, false, key, x, y };
+		if (Engine *engine = current()) engine->dispatchInput(event);
 	}
 
 	void Engine::specialKeyboardUpWrapper(int key, int x, int y){
-		instance->specialKeyboardUp(key, x, y);
+		InputLogEvent event = { InputEvent::SPECIAL_UP, false, key, x, y };
+		if (Engine *engine = current()) engine->dispatchInput(event);
 	}
 
 	void Engine::specialKeyboardDownWrapper(int key, int x, int y){
-		instance->specialKeyboardDown(key, x, y);
+		InputLogEvent event = { InputEvent::SPECIAL_DOWN, false, key, x, y };
+		if (Engine *engine = current()) engine->dispatchInput(event);
 	}
 }
\ No newline at end of file
@@ -22,10 +22,34 @@
 #pragma once
 #include <sstream>
 #include <GL\glut.h>
+#include <typeindex>
+#include <typeinfo>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
+#include "AllocationTracker.h"
+#include "Broadphase.h"
+#include "Clock.h"
+#include "CommandQueue.h"
 #include "Element.h"
+#include "ElementDispatch.h"
+#include "ElementHandle.h"
+#include "ElementPool.h"
+#include "ElementStore.h"
+#include "FrameArena.h"
+#include "FrameCapture.h"
+#include "HeadlessContext.h"
+#include "Input.h"
+#include "InputLog.h"
+#include "JobSystem.h"
 #include "Keyboard.h"
+#include "ParticleSystem.h"
+#include "Profiler.h"
+#include "RenderBatch.h"
+#include "RenderQueue.h"
+#include "SceneGraph.h"
+#include "StaticLayer.h"
 
 namespace glFrameworkBasic {
 	/**
@@ -38,12 +62,22 @@ namespace glFrameworkBasic {
 	* Vector elements are deleted in destructor.
 	* CAUTION: GLUT provides no provisions for returning to main. Must have engine
 	* or derived class instance as a global in main() to call destructor. Alternative
-	* is to use atexit().
+	* is to use atexit(). The headless backend does return from Begin(), so an
+	* engine running headless can live on the stack.
+	* Engines share no state: GLUT callbacks are routed to the engine owning the
+	* current window, and headless engines can run side by side on different
+	* threads (see HeadlessBatch).
 	*/
 	class Engine
 	{
 	public:
-		/// <summary>Engine default constructor. Sets instance pointer to self.</summary>
+		/// <summary>Selects how Begin() drives the frame loop.</summary>
+		enum Backend {
+			BACKEND_GLUT,		// GLUT window, frames paced by the GLUT timer.
+			BACKEND_HEADLESS	// Offscreen context, frames run back to back.
+		};
+
+		/// <summary>Engine default constructor.</summary>
 		Engine();
 
 		/// <summary>
@@ -58,9 +92,10 @@ namespace glFrameworkBasic {
 		/// <summary>
 		/// Destructor for Engine. Properly deletes all items in draw vector
 		/// because it uses pointers to store objects polymorphically.
-		/// Iterates and calls delete.
+		/// Iterates and calls delete. Virtual so derived engines can be deleted
+		/// through Engine pointers, as HeadlessBatch does.
 		/// </summary>
-		~Engine();
+		virtual ~Engine();
 
 		/// <summary>
 		/// Set size of drawn window in pixels.
@@ -88,18 +123,387 @@ namespace glFrameworkBasic {
 		/// </summary>
 		void SetWindowTitle(std::string title);
 
+		/// <summary>
+		/// Creates a T in the engine's pool for T, adds it to drawItems and
+		/// returns a handle to it. Constructor arguments are forwarded.
+		/// Pooled elements are freed by Despawn() or the Engine destructor.
+		/// </summary>
+		template <class T, class... Args>
+		ElementHandle Spawn(Args&&... args);
+
+		/// <summary>
+		/// Queues an element made by Spawn() for removal. It is removed from
+		/// drawItems and returned to its pool at the end of the current update
+		/// step, so pointers stay valid through Move() and collide().
+		/// Removal moves the last element into its place in drawItems.
+		/// Stale and null handles are ignored. Call from the display thread.
+		/// </summary>
+		void Despawn(ElementHandle handle);
+
+		/// <summary>Element a handle refers to, or NULL if it was despawned.</summary>
+		Element *Get(ElementHandle handle) const;
+
+		/// <summary>Get() cast to the spawned type.</summary>
+		template <class T>
+		T *Get(ElementHandle handle) const { return static_cast<T *>(Get(handle)); }
+
+		/// <summary>True while the element a handle refers to exists.</summary>
+		bool IsAlive(ElementHandle handle) const;
+
+		/// <summary>
+		/// Attaches child to parent: child's position, scale and angle become
+		/// relative to parent and it is drawn, culled and collided in parent's
+		/// space. World transforms are cached and recomputed after each update
+		/// step, only for elements that changed and their descendants. Move()
+		/// overrides that change an element with children directly must call
+		/// MarkDirty(). Returns false if parent is child or below it.
+		/// Despawning a parent leaves its children as roots.
+		/// </summary>
+		bool Attach(Element *child, Element *parent);
+
+		/// <summary>Attach() by handle. False if either handle is stale.</summary>
+		bool Attach(ElementHandle child, ElementHandle parent);
+
+		/// <summary>Makes child a root again; its position is then in world space.</summary>
+		void Detach(Element *child);
+
+		/// <summary>
+		/// Queue other threads use to create, update and destroy elements.
+		/// Pushing is lock-free and safe from any thread; display() runs the
+		/// commands before preDisplayLoop().
+		/// </summary>
+		CommandQueue &GetCommandQueue();
+
+		/// <summary>
+		/// Most queued commands run per frame, so a burst is spread over
+		/// several frames instead of stalling one. 0 runs all of them.
+		/// Default 10000.
+		/// </summary>
+		void SetCommandBudget(size_t commands);
+
+		/// <summary>
+		/// Pool used by Spawn<T>(), created on first use. Call Reserve() on it
+		/// before a spawn burst to allocate up front.
+		/// </summary>
+		template <class T>
+		ElementPool<T> &Pool();
+
+		/// <summary>
+		/// Enable or disable batched drawing. When enabled display() calls
+		/// Element::Submit() instead of Draw(), collecting every element into
+		/// one vertex array that is drawn with a few glDrawArrays calls.
+		/// Elements whose Submit() returns false are still drawn with Draw().
+		/// Default false.
+		/// </summary>
+		void SetBatching(bool doBatch);
+
+		/// <summary>
+		/// With batching, draw built-in shapes (the sample square and circles)
+		/// as instances: shape vertices live in a vertex buffer, per instance
+		/// transforms and colors are streamed each frame, and each run of one
+		/// shape is a single instanced draw call with a shader. Falls back to
+		/// the CPU transformed batch when the context lacks buffer objects,
+		/// shaders or instanced arrays. Runs are longest with SetDrawSorting().
+		/// Default false.
+		/// </summary>
+		void SetInstancing(bool doInstance);
+
+		/// <summary>
+		/// Run the update phase (store integration and every Move()) in parallel
+		/// chunks on the engine's job system. Move() overrides must then only
+		/// change their own element. Drawing stays on the GLUT thread.
+		/// Default false.
+		/// </summary>
+		void SetParallelUpdate(bool doParallel);
+
+		/// <summary>
+		/// Skip the draw functions of elements whose GetBounds() lies outside
+		/// the visible world rectangle. Elements that draw past their bounds
+		/// must override GetBounds() or be clipped too early.
+		/// Default true.
+		/// </summary>
+		void SetCulling(bool doCull);
+
+		/// <summary>Number of elements drawn in the last draw pass.</summary>
+		unsigned int GetDrawnCount() const;
+
+		/// <summary>
+		/// Frame profiler. display() times its phases (preDisplayLoop, update,
+		/// collide, draw, postDisplayLoop, swapBuffers) and the whole frame into
+		/// it while enabled. It is current on the display thread and on update
+		/// workers, so GLFRAMEWORK_PROFILE_SCOPE works in hooks and Move().
+		/// Disabled by default; --profile on the command line enables it.
+		/// </summary>
+		Profiler &GetProfiler();
+
+		/// <summary>
+		/// Also time the draw pass per element type, one sample per run of
+		/// consecutive elements of the same type. Default false.
+		/// </summary>
+		void SetProfileElementTypes(bool doProfile);
+
+		/// <summary>
+		/// Update and draw elements made by Spawn<T>() one concrete type at a
+		/// time with non-virtual, inlinable calls, skipping BeforeDraw() and
+		/// AfterDraw() for types that do not override them. Types are drawn in
+		/// the order they were first spawned, then elements added with new in
+		/// drawItems order, so overlapping elements of different types may
+		/// change stacking. Default false.
+		/// </summary>
+		void SetTypeSorted(bool doSort);
+
+		/// <summary>
+		/// Draw elements in sort key order instead of drawItems order: by
+		/// Element::SetDrawLayer(), then zPos (world z for attached elements),
+		/// then type and Element::GetMaterialId(), so layering follows zPos
+		/// and neighbours share primitive type and GL state. Keys are radix
+		/// sorted each frame, and the previous order is reused when no key
+		/// changed. Elements with equal keys keep drawItems order. With
+		/// SetTypeSorted() each run of one type is drawn by its typed loop.
+		/// Default false.
+		/// </summary>
+		void SetDrawSorting(bool doSort);
+
+		/// <summary>
+		/// Pipelined mode: while the display thread draws the last frame's
+		/// state from a snapshot of element transforms, a job simulates the
+		/// next frame's update steps on the job system, and display() waits
+		/// for it before postDisplayLoop(). The screen shows the scene one
+		/// frame late, but the frame takes max(update, draw) instead of the
+		/// sum when a worker thread is free.
+		/// Drawing goes through Element::Submit() with the snapshot transform,
+		/// so Submit() must not read members that Move() changes. An element
+		/// whose Submit() returns false makes the draw wait for the simulation,
+		/// then Draw() runs with the snapshot position, angle and scale swapped
+		/// in. Move() and collide() run on a worker, as with SetParallelUpdate();
+		/// BeforeDraw() and AfterDraw() run when the snapshot is taken, before
+		/// the simulation starts. Despawns wait until the simulation is done.
+		/// Elements are drawn in drawItems order, or sorted as set with
+		/// SetDrawSorting(). Default false.
+		/// </summary>
+		void SetPipelined(bool doPipeline);
+
+		/// <summary>Elements per parallel update chunk. Default 1024.</summary>
+		void SetUpdateGrainSize(unsigned int elements);
+
+		/// <summary>
+		/// Cache static content in an offscreen layer: drawStaticLayer() and
+		/// every element flagged with Element::SetStatic() are rendered into a
+		/// framebuffer object once and the image is drawn as the background of
+		/// each frame. The layer is rendered again on reshape, when a static
+		/// element changes or is despawned, and on InvalidateStaticLayer().
+		/// Without framebuffer object support, or when disabled, the static
+		/// content is drawn every frame as before. Default false.
+		/// </summary>
+		void SetStaticLayer(bool doCache);
+
+		/// <summary>Render the static layer again on the next frame.</summary>
+		void InvalidateStaticLayer();
+
+		/// <summary>
+		/// Set the collision broadphase, for example a SpatialHashBroadphase or
+		/// AabbTreeBroadphase. After every update step the engine refreshes it
+		/// with drawItems and calls collide() once per overlapping pair.
+		/// Engine takes ownership and deletes it. NULL (default) disables it.
+		/// </summary>
+		void SetBroadphase(Broadphase *phase);
+
+		/// <summary>
+		/// Set the length of one simulation step in seconds. Every step calls
+		/// Move() once, so velocities are in units per step.
+		/// Default 0.030, the old 30 ms frame timer.
+		/// </summary>
+		void SetTimestep(double seconds);
+
+		/// <summary>
+		/// Most update steps run in one frame. When a slow frame owes more,
+		/// the backlog is dropped so the simulation cannot spiral. Default 5.
+		/// </summary>
+		void SetMaxStepsPerFrame(int steps);
+
+		/// <summary>
+		/// Draw elements between their previous and current step so motion
+		/// stays smooth when the display rate differs from the step rate.
+		/// Default true. The headless backend always draws the current step.
+		/// </summary>
+		void SetInterpolation(bool doInterpolate);
+
+		/// <summary>
+		/// Set how often GLUT redisplays, independent of the timestep.
+		/// 0 or less redisplays as fast as possible from the idle callback.
+		/// Default 33.3 (30 ms). Must be set before calling Begin().
+		/// </summary>
+		void SetFrameRate(double framesPerSecond);
+
+		/// <summary>
+		/// Only redisplay while something can change. Frames keep running while
+		/// an element is animating (see Element::IsAnimating()), was changed
+		/// through a Set function, was spawned or despawned, or RequestRedraw()
+		/// was called; input and reshape always redraw. Otherwise the frame
+		/// timer drops to a slow poll of the elements' dirty flags and the
+		/// screen costs next to no CPU. GLUT backend only. Default false.
+		/// </summary>
+		void SetRedrawOnDemand(bool onDemand);
+
+		/// <summary>
+		/// Ask for another frame when redrawing on demand, for changes the
+		/// engine cannot see, such as drawing in preDisplayLoop().
+		/// </summary>
+		void RequestRedraw();
+
+		/// <summary>Number of fixed update steps run since Begin().</summary>
+		unsigned long long GetTickCount() const;
+
+		/// <summary>
+		/// Select the backend used by Begin(). Default is BACKEND_GLUT.
+		/// Passing --headless on the command line also selects BACKEND_HEADLESS.
+		/// Must be set before calling Begin().
+		/// </summary>
+		void SetBackend(Backend backend);
+
+		/// <summary>
+		/// Number of frames the headless backend renders before Begin() returns.
+		/// Default 0, which runs until Stop() is called.
+		/// </summary>
+		void SetFrameLimit(unsigned int frames);
+
+		/// <summary>
+		/// Ask the headless backend to return from Begin() after the current frame.
+		/// Has no effect on the GLUT backend.
+		/// </summary>
+		void Stop();
+
+		/// <summary>
+		/// Record every input callback and each frame's update step count to a
+		/// binary log, for ReplayInput() or --replay. Call before Begin().
+		/// Passing --record file on the command line does the same.
+		/// Returns false if the file cannot be created.
+		/// </summary>
+		bool RecordInput(const std::string &path);
+
+		/// <summary>
+		/// Record every everyNth frame to path: Y4M video when the name ends in
+		/// .y4m, raw RGBA frames otherwise. Frames are read back asynchronously
+		/// through pixel buffers and written by a background thread; frames are
+		/// dropped, not waited for, when the disk falls behind (see
+		/// GetFrameCapture()). A headless Begin() stops the capture when its
+		/// loop ends. Passing --capture file on the command line does the same
+		/// with everyNth 1. Returns false if the file cannot be created.
+		/// </summary>
+		bool StartCapture(const std::string &path, unsigned int everyNth = 1);
+
+		/// <summary>Writes the frames still in flight and closes the capture file.</summary>
+		void StopCapture();
+
+		/// <summary>Capture state and counters.</summary>
+		const FrameCapture &GetFrameCapture() const { return frameCapture; }
+
+		/// <summary>
+		/// Heap allocations made on the display thread during each frame, per
+		/// profiler phase and call site. Counting needs the framework built
+		/// with GLFRAMEWORK_TRACK_ALLOCATIONS; otherwise the tracker stays empty.
+		/// </summary>
+		AllocationTracker &GetAllocationTracker() { return allocations; }
+
+		/// <summary>Start or stop counting allocations. --allocations on the command line enables it.</summary>
+		void SetAllocationTracking(bool doTrack);
+
+		/// <summary>
+		/// Treat any heap allocation in a frame after the first warmupFrames as
+		/// a bug: debug builds assert at the allocating code, release builds
+		/// count it and report the frame on std::cerr. 0 turns the guard off.
+		/// --allocation-guard frames on the command line does the same.
+		/// </summary>
+		void SetAllocationGuard(unsigned int warmupFrames);
+
+		/// <summary>
+		/// Scratch memory reset at the start of every frame. Use it from hooks
+		/// and Draw() for per-frame temporaries instead of the heap; it stops
+		/// allocating once its block covers the largest frame.
+		/// </summary>
+		FrameArena &GetFrameArena() { return frameArena; }
+
+		/// <summary>
+		/// Replay a log made by RecordInput(). Begin() then runs headless at full
+		/// speed, feeds the recorded input before the same update steps, returns
+		/// when the log ends and prints GetStateChecksum(). setup() must build
+		/// the same scene and game logic must not depend on wall time.
+		/// Passing --replay file on the command line does the same.
+		/// Returns false if the file is missing or not an input log.
+		/// </summary>
+		bool ReplayInput(const std::string &path);
+
+		/// <summary>
+		/// 64-bit FNV-1a hash of the tick count and every element's position,
+		/// velocity, scale, angle and show flag. Equal after two runs when the
+		/// simulation was identical.
+		/// </summary>
+		unsigned long long GetStateChecksum() const;
+
+		/// <summary>Input delivered for the current frame.</summary>
+		const Input &GetInput() const;
+
+		/// <summary>
+		/// The engine's particle system. It is updated every fixed step after
+		/// the elements and drawn on top of them with one draw call.
+		/// </summary>
+		ParticleSystem &GetParticles();
+
+		/// <summary>Number of frames displayed since Begin().</summary>
+		unsigned int GetFrameCount() const;
+
+		/// <summary>
+		/// Reads back the headless framebuffer as RGBA rows, bottom row first.
+		/// Empty when running under GLUT or when no offscreen context exists.
+		/// </summary>
+		const std::vector<unsigned char> &GetFramebuffer();
+
+		/// <summary>
+		/// True when frames are drawn by OpenGL: always under GLUT, and headless
+		/// once Begin() created the offscreen context. False means GL calls are
+		/// dropped and draw timings measure nothing.
+		/// </summary>
+		bool HasGLContext() const;
+
 		/// <summary>
 		/// Function that initializes GLUT properties, calls initGL, creates a window,
 		/// and enters the main loop. Careful, GLUT has designed the main loop to never
-		/// return.
+		/// return. With BACKEND_HEADLESS no window is made: display() is called in a
+		/// tight loop against an offscreen context and Begin() returns when done.
 		/// </summary>
 		void Begin(int argc, char **argv);
 
+		/// <summary>
+		/// The GLUT part of Begin() without entering the main loop: initializes
+		/// GLUT once per process, creates this engine's window, registers the
+		/// callbacks and runs initGL() and setup(). Open several engines this
+		/// way, then call Begin() on the last one (or glutMainLoop()) to run
+		/// them all in one event loop.
+		/// </summary>
+		void OpenWindow(int argc, char **argv);
+
 	protected:
 		std::vector<Element *> drawItems;
 
-		static const int refreshMills = 30; // refresh interval in milliseconds
+		// Structure-of-arrays state for elements bound with Element::BindStore().
+		// Integrated in one pass per frame instead of calling their Move().
+		ElementStore elementStore;
+		bool storeStale;	// Bound elements' members lag elementStore, see syncStore()
+
+		// Parent / child links and cached world transforms, see Attach().
+		SceneGraph sceneGraph;
+
+		// Particles, stepped with the elements and drawn after them.
+		ParticleSystem particles;
+
+		int refreshMills;		// Redisplay interval in milliseconds, 0 for uncapped
 		float MatrixProjectionScale; // Scale used for reshape function to determine unit scale.
+		int viewportWidth;		// Current viewport width in pixels, set by reshape
+		int viewportHeight;		// Current viewport height in pixels, set by reshape
+		float pixelsPerUnit;	// Window pixels per world unit, set by reshape
+		Aabb viewBounds;		// World rectangle shown by the projection, set by reshape
+		bool culling;			// Skip elements outside viewBounds when drawing
+		unsigned int drawnCount;	// Elements drawn in the last draw pass
 		int WINDOW_WIDTH;		// Window width in pixels
 		int WINDOW_HEIGHT;	// Window height in pixels
 		int WINDOW_POS_X;		// Window top left position (x) in pixels
@@ -107,12 +511,161 @@ namespace glFrameworkBasic {
 		bool DO_FULL_SCN;		// If the window should open in full-screen
 		std::string windowTitle;
 
-		// Instance pointer to self. Needed for passing event handlers to glut.
-		static Engine *instance;
+		Backend backend;			// Frame loop driver selected for Begin()
+		unsigned int frameLimit;	// Headless frames to run, 0 for no limit
+		unsigned int frameCount;	// Frames displayed since Begin()
+		bool stopRequested;			// Set by Stop() to leave the headless loop
+		HeadlessContext headlessContext;
+
+		StaticLayer staticLayer;	// Cached background, after headlessContext so it is freed first
+		FrameCapture frameCapture;	// Also freed while the headless context lives
+		bool staticLayerEnabled;	// SetStaticLayer()
+		bool staticLayerDirty;		// Re-render on the next frame
+		bool staticLayerActive;		// This frame composited the layer, skip static elements
+
+		// Handle table for spawned elements. Free slots are chained through nextFree.
+		struct HandleSlot {
+			Element *element;		// NULL while the slot is free
+			unsigned int generation;	// Bumped on despawn to invalidate handles
+			unsigned int drawIndex;	// Position of element in drawItems
+			unsigned int nextFree;	// Next free slot, or ElementHandle::NULL_INDEX
+			CommandTicket ticket;	// Create command that spawned it, or 0
+		};
+		std::vector<HandleSlot> handleSlots;
+		unsigned int freeHandle;	// First free handle slot
+		std::vector<ElementHandle> pendingDespawns;	// Applied by applyDespawns()
+		std::unordered_map<std::type_index, ElementPoolBase *> pools;	// One per spawned type, owned
+
+		// Per pass settings and counters shared by the drawRange() calls of one draw pass.
+		struct DrawState {
+			bool blend;			// Interpolate positions
+			float alpha;
+			bool cull;
+			Aabb view;
+			bool staticPass;	// Drawing the static layer
+			bool skipStatic;	// Static elements are in the layer
+			bool timeTypes;		// Record per-type profiler samples
+			const char *runType;	// Type of the current timing run
+			long long runStart;
+			unsigned int drawn;
+		};
+
+		// Typed loops for one pool, instantiated by Pool<T>() with ExactDispatch<T>.
+		// update and draw walk the pool's live list, drawSorted a run of the render queue.
+		struct TypeGroup {
+			ElementPoolBase *pool;
+			void (*update)(Engine &engine, const ElementPoolBase &items, size_t begin, size_t end);
+			void (*draw)(Engine &engine, const ElementPoolBase &items, size_t begin, size_t end, DrawState &state);
+			void (*drawSorted)(Engine &engine, Element *const *const &items, size_t begin, size_t end, DrawState &state);
+		};
+		std::vector<TypeGroup> typeGroups;	// In order of first Spawn()
+		bool typeSorted;			// Use typeGroups for update and draw
+		bool drawSorting;			// Draw in renderQueue order
+		RenderQueue renderQueue;	// Shown elements by sort key, see SetDrawSorting()
+
+		/// <summary>Fills renderQueue with the shown elements and sorts it.</summary>
+		void sortDrawItems();
+
+		CommandQueue commands;
+		size_t commandBudget;		// Commands run per frame, 0 for all
+		std::unordered_map<CommandTicket, ElementHandle> commandElements;	// Elements made by Create commands
+
+		/// <summary>Runs up to commandBudget queued commands. Called by display().</summary>
+		void applyCommands();
+
+		/// <summary>Elements in drawItems that did not come from a pool.</summary>
+		size_t unpooledCount() const;
+
+		/// <summary>
+		/// Removes queued despawns from drawItems with swap-and-pop and frees
+		/// them. Called by display() after each update step.
+		/// </summary>
+		void applyDespawns();
+
+		bool parallelUpdate;		// Run updateElements() on the job system
+		unsigned int updateGrainSize;	// Elements per parallel update chunk
+		JobSystem *jobSystem;		// Created on first use by Jobs()
+
+		/// <summary>
+		/// Work-stealing thread pool owned by the engine, created on first use.
+		/// Subclasses may schedule their own jobs, for example from
+		/// preDisplayLoop(), and call Wait() before touching the results.
+		/// </summary>
+		JobSystem &Jobs();
+
+		Broadphase *broadphase;		// Optional collision broadphase, owned
+		std::vector<ElementPair> collisionPairs;	// Candidate pairs of the last step
+
+		Clock frameClock;			// Monotonic clock driving the fixed timestep
+		double timestep;			// Seconds per update step
+		int maxStepsPerFrame;		// Spiral-of-death cap on steps per frame
+		double accumulator;			// Real time not yet consumed by steps
+		double lastFrameTime;		// frameClock time of the previous frame
+		unsigned long long tickCount;	// Update steps run since Begin()
+		bool interpolate;			// Draw between previous and current step
+		float interpolationAlpha;	// Blend factor for this frame's draw pass
+
+		// What the pipelined draw pass needs of an element, taken before the
+		// simulation job starts changing it.
+		struct SnapshotItem {
+			Element *element;
+			Transform transform;		// Interpolated, for Submit()
+			float xPos, yPos, zPos, rotAngle;	// Interpolated, for Draw()
+			float xScale, yScale, zScale;
+			bool attached;				// Has a parent, Draw() needs parentWorld
+			Transform parentWorld;
+		};
+		bool pipelined;				// Simulate on a job while drawing the snapshot
+		float snapshotAlpha;		// interpolationAlpha of the frame being drawn
+		std::vector<SnapshotItem> snapshot;	// Elements to draw, in draw order
+		// The frame's simulation job; kept here so scheduling it does not allocate.
+		int simulateSteps;			// Update steps the job runs
+		Profiler *simulateProfiler;	// Profiler the job records into
+		std::atomic<size_t> simulating;	// 1 while the job runs
+
+		bool redrawOnDemand;		// Stop redisplaying while the scene is unchanged
+		bool redrawActive;			// Frames are being scheduled, false while idle
+		bool redrawRequested;		// RequestRedraw() or input since the last frame
+		bool wasAnimating;			// Something animated last frame, draw it settled
+		size_t drawnItemCount;		// drawItems.size() at the last frame
+		int timerGeneration;		// Timer chains with an older value stop
+		static const int IDLE_POLL_MILLS = 250;	// Dirty flag poll interval while idle
+
+		/// <summary>
+		/// Checks and clears the change tracking after a frame. True if another
+		/// frame is needed.
+		/// </summary>
+		bool sceneChanging();
+
+		/// <summary>True if an element was changed through a Set function since the last frame.</summary>
+		bool anyElementDirty() const;
+
+		/// <summary>Resumes frame scheduling after an idle period.</summary>
+		void wakeRedraw();
+
+		/// <summary>Stops frame scheduling and starts polling for changes.</summary>
+		void sleepRedraw();
+
+		Profiler profiler;			// Phase timings, see GetProfiler()
+		AllocationTracker allocations;	// Per-phase heap allocations, see GetAllocationTracker()
+		FrameArena frameArena;		// Per-frame scratch memory, reset by runFrame()
+		bool profileElementTypes;	// Time the draw pass per element type
+
+		bool batching;				// Draw through renderBatch instead of Draw()
+		RenderBatch renderBatch;	// Per-frame vertex batch fed by Element::Submit()
+
 
 		// Keyboard state manager
 		Keyboard keyStates;
 
+		// Timestamped input queue, delivered once per frame before display().
+		// Query pressed / released this frame from preDisplayLoop() or Move().
+		Input input;
+
+		InputLog inputLog;			// Recording or replay log, see RecordInput()
+		std::vector<InputLogEvent> replayEvents;	// Events of the frame being replayed
+		int replaySteps;			// Update steps of the frame being replayed
+
 		/// <summary>Contains initilization procedures for GLUT.</summary>
 		virtual void initGL();
 
@@ -126,10 +679,78 @@ namespace glFrameworkBasic {
 		/// display is called every frame and contains logic for iterating
 		/// vector, calling move, checking collision, and drawing.
 		/// May be overwritten by a subclass, but subclass must at least call 
-		/// glClear, glMatrixMode, glLoadIdentity, and glutSwapBuffers.
+		/// glClear, glMatrixMode, glLoadIdentity, and swapBuffers.
 		/// </summary>
 		virtual void display();
 
+		/// <summary>
+		/// Runs one fixed update step: integrates the element store and calls
+		/// Move() on every other element.
+		/// </summary>
+		void updateElements();
+
+		/// <summary>Refreshes the broadphase and calls collide() for each candidate pair.</summary>
+		void findCollisions();
+
+		/// <summary>
+		/// Copies the store's positions into its bound elements if a step
+		/// moved them since the last call. Done before anything reads their
+		/// members: the scene graph and collisions of a step, and the end of
+		/// the frame's steps.
+		/// </summary>
+		void syncStore();
+
+		/// <summary>
+		/// Draw pass: BeforeDraw, Draw (or Submit when batching) and AfterDraw
+		/// on every shown element inside viewBounds, interpolated by
+		/// interpolationAlpha. Static elements are left out while the static
+		/// layer is in use; staticPass draws only them, for the layer.
+		/// </summary>
+		void drawElements(bool staticPass = false);
+
+		/// <summary>
+		/// Runs the update steps of one frame: updateElements() and
+		/// findCollisions() per step, applying despawns after each step when
+		/// applyEachStep is true.
+		/// </summary>
+		void simulate(int steps, bool applyEachStep);
+
+		/// <summary>Pipelined mode's job: simulate() without despawns, then clears simulating.</summary>
+		static void simulateJob(void *engine);
+
+		/// <summary>
+		/// Pipelined mode: records every element drawElements() would draw
+		/// into snapshot, calling BeforeDraw() and AfterDraw() on the way.
+		/// </summary>
+		void captureSnapshot(float alpha);
+
+		/// <summary>
+		/// Pipelined mode: draws snapshot through the batch. Waits on
+		/// simulating before drawing any element with Draw().
+		/// </summary>
+		void drawSnapshot();
+
+		/// <summary>
+		/// Draws the static background: composites the cached layer, rendering
+		/// it first if stale, or calls drawStaticLayer() directly when the
+		/// layer is off. Called by display() right after clearing.
+		/// </summary>
+		void drawStatic();
+
+		/// <summary>
+		/// Generic function not implemented in base class. Draws background
+		/// that rarely changes, such as walls, grids or borders. Called once
+		/// per static layer render when SetStaticLayer(true) is in effect,
+		/// otherwise at the start of every frame.
+		/// </summary>
+		virtual void drawStaticLayer();
+
+		/// <summary>
+		/// Presents the finished frame. Calls glutSwapBuffers under GLUT and
+		/// flushes the offscreen context when headless.
+		/// </summary>
+		void swapBuffers();
+
 		/// <summary>
 		/// Generic function not implemented in base class. Is called
 		/// the before looping through vector in display(). Suggested uses
@@ -144,16 +765,24 @@ namespace glFrameworkBasic {
 		/// </summary>
 		virtual void postDisplayLoop();
 
+		/// <summary>
+		/// Generic function not implemented in base class. Called after each
+		/// update step for every pair of elements whose bounds overlap, when a
+		/// broadphase is set. Do the exact collision test and response here.
+		/// </summary>
+		virtual void collide(Element *a, Element *b);
+
 		/// <summary>
 		/// Called on start and when window is resized.
 		/// Designed to preserve aspect ration on different size windows
-		/// so that objects are not distorted.
+		/// so that objects are not distorted. Also records the viewport and
+		/// pixels-per-unit scale used for level of detail.
 		/// </summary>
 		virtual void reshape(GLsizei width, GLsizei height);
 
 		/// <summary>
 		/// Post a re-paint request.
-		/// Not needed when using double buffers.
+		/// Registered as the GLUT idle callback when the frame rate is uncapped.
 		/// </summary>
 		virtual void idle();
 
@@ -162,6 +791,13 @@ namespace glFrameworkBasic {
 		/// Clock governed by refreshMills
 		/// </summary>
 		static void timer(int value);
+
+		/// <summary>
+		/// Advances the fixed timestep accumulator by the real time since the
+		/// last frame and returns how many update steps this frame should run.
+		/// Also sets interpolationAlpha.
+		/// </summary>
+		int advanceClock();
 		
 		/// <summary>
 		/// Mouse Press event handler. Not implemented, must override.
@@ -204,55 +840,258 @@ namespace glFrameworkBasic {
 		/// <summary>Generate window for OpenGL</summary>
 		void generateWindow();
 
+		/// <summary>Gives a spawned element a handle and appends it to drawItems.</summary>
+		ElementHandle addSpawned(Element *element);
+
+		/// <summary>Returns an element to its pool, or deletes it if it was made with new.</summary>
+		static void destroyElement(Element *element);
+
+		/// <summary>
+		/// Runs display() as one profiled frame and counts it. Used by both
+		/// backends' frame loops.
+		/// </summary>
+		void runFrame();
+
+		/// <summary>
+		/// Single entry for input from the GLUT wrappers and from replay: writes
+		/// it to the recording, queues it on input and calls the virtual handler.
+		/// </summary>
+		void dispatchInput(const InputLogEvent &event);
+
+		/// <summary>
+		/// Update step body for items[begin, end): SavePreviousState, then
+		/// Move() through Calls. Store-bound elements are skipped, the store
+		/// integrated them and syncStore() catches their members up. items is
+		/// a container read by index on every iteration, never a base pointer,
+		/// because Move() may Spawn() and reallocate it.
+		/// </summary>
+		template <class Calls, class Items>
+		static void updateRange(const Items &items, size_t begin, size_t end);
+
+		/// <summary>Draw pass body for items[begin, end) through Calls. Indexes items like updateRange().</summary>
+		template <class Calls, class Items>
+		void drawRange(const Items &items, size_t begin, size_t end, DrawState &state);
+
+		/// <summary>Draw() through Calls, inside parentWorld when attached.</summary>
+		template <class Calls>
+		static void drawAttached(Element *item, bool attached, const Transform &parentWorld);
+
+		template <class T>
+		static void updateGroup(Engine &engine, const ElementPoolBase &items, size_t begin, size_t end);
+
+		template <class T, class Items>
+		static void drawGroup(Engine &engine, const Items &items, size_t begin, size_t end, DrawState &state);
+
+		/// <summary>Sets the member defaults shared by the constructors.</summary>
+		void initDefaults(float projectionScale);
+
+		/// <summary>
+		/// Headless frame loop. Creates the offscreen context, runs initGL, reshape
+		/// and setup, then calls display() until the frame limit or Stop().
+		/// </summary>
+		void runHeadless();
+
 		/// <summary>
 		/// Static function to point to instance function.
 		/// Necessary for GLUT to pass static function to glutDisplayFunc.
-		/// Uses instance pointer for call.
+		/// Routed to the engine of the current window.
 		/// </summary>
 		static void displayWrapper();
 
+		/// <summary>
+		/// Static function to point to instance function.
+		/// Registered with glutIdleFunc while a window's frame rate is uncapped;
+		/// calls idle() on every such engine.
+		/// </summary>
+		static void idleWrapper();
+
 		/// <summary>
 		/// Static function to point to instance function.
 		/// Necessary for GLUT to pass static function to glutReshapeFunc.
-		/// Uses instance pointer for call.
+		/// Routed to the engine of the current window.
 		/// </summary>
 		static void reshapeWrapper(GLsizei width, GLsizei height);
 
 		/// <summary>
 		/// Static function to point to instance function.
-		/// Uses instance pointer for call.
+		/// Routed to the engine of the current window.
 		/// </summary>
 		static void mousePressWrapper(int button, int state, int x, int y);
 
 		/// <summary>
 		/// Static function to point to instance function.
-		/// Uses instance pointer for call.
+		/// Routed to the engine of the current window.
 		/// </summary>
 		static void mouseMoveWrapper(int x, int y);
 
+		/// <summary>
+		/// Static function registered with glutPassiveMotionFunc. Only feeds
+		/// the input queue; mouseMoveFunc() still fires for drags only.
+		/// </summary>
+		static void passiveMouseMoveWrapper(int x, int y);
+
 		/// <summary>
 		/// Static function to point to instance function.
-		/// Uses instance pointer for call.
+		/// Routed to the engine of the current window.
 		/// </summary>
 		static void keyboardUpWrapper(unsigned char key, int x, int y);
 
 		/// <summary>
 		/// Static function to point to instance function.
-		/// Uses instance pointer for call.
+		/// Routed to the engine of the current window.
 		/// </summary>
 		static void keyboardDownWrapper(unsigned char key, int x, int y);
 
 		/// <summary>
 		/// Static function to point to instance function.
-		/// Uses instance pointer for call.
+		/// Routed to the engine of the current window.
 		/// </summary>
 		static void specialKeyboardUpWrapper(int key, int x, int y);
 
 		/// <summary>
 		/// Static function to point to instance function.
-		/// Uses instance pointer for call.
+		/// Routed to the engine of the current window.
 		/// </summary>
 		static void specialKeyboardDownWrapper(int key, int x, int y);
 
+		int window;					// GLUT window id, 0 before OpenWindow()
+		static std::unordered_map<int, Engine *> windows;	// Window id to engine, for the wrappers
+		static std::vector<int> idleWindows;	// Reused by idleWrapper()
+
+		/// <summary>Engine owning the current GLUT window, or NULL.</summary>
+		static Engine *current();
+
+		/// <summary>Engine owning window, or NULL.</summary>
+		static Engine *forWindow(int window);
+
+		// Timer values carry the engine's timer slot and the chain's
+		// generation. Slots are small and reused, unlike GLUT window ids.
+		struct TimerSlot {
+			Engine *engine;			// NULL while free
+			int generation;			// Where the next owner's chains start
+		};
+		static const int TIMER_SLOTS = 1024;
+		static std::vector<TimerSlot> timerSlots;
+		int timerSlot;				// Index in timerSlots, -1 before OpenWindow()
+		int timerValue() const;
+
+		/// <summary>Starts a timer chain with the current generation. Needs a timer slot.</summary>
+		void startTimer(unsigned int millis);
+
+		/// <summary>Engine whose timer chain value belongs to, or NULL.</summary>
+		static Engine *forTimer(int value);
+
+		/// <summary>Claims a free timer slot for this engine. False when all are taken.</summary>
+		bool acquireTimerSlot();
+
+		/// <summary>
+		/// Registers idleWrapper() while any window needs idle redisplays.
+		/// GLUT has one idle function for all windows.
+		/// </summary>
+		static void updateIdleFunc();
+
 	};
+
+	template <class T, class... Args>
+	ElementHandle Engine::Spawn(Args&&... args){
+		ElementPool<T> &pool = Pool<T>();
+		T *element = pool.Create(std::forward<Args>(args)...);
+		element->pool = &pool;
+		return addSpawned(element);
+	}
+
+	template <class T>
+	ElementPool<T> &Engine::Pool(){
+		ElementPoolBase *&pool = pools[std::type_index(typeid(T))];
+		if (pool == NULL) {
+			pool = new ElementPool<T>();
+			TypeGroup group = { pool, &Engine::updateGroup<T>,
+				&Engine::drawGroup<T, ElementPoolBase>, &Engine::drawGroup<T, Element *const *> };
+			typeGroups.push_back(group);
+			pool->typeIndex = (unsigned int)typeGroups.size();
+		}
+		return *static_cast<ElementPool<T> *>(pool);
+	}
+
+	template <class T>
+	CommandTicket CommandQueue::Create(const std::function<void(T &)> &init){
+		return Create([init](Engine &engine) -> ElementHandle {
+			ElementHandle handle = engine.Spawn<T>();
+			if (init) init(*engine.Get<T>(handle));
+			return handle;
+		});
+	}
+
+	template <class T>
+	void Engine::updateGroup(Engine &/*engine*/, const ElementPoolBase &items, size_t begin, size_t end){
+		updateRange<ExactDispatch<T> >(items, begin, end);
+	}
+
+	template <class T, class Items>
+	void Engine::drawGroup(Engine &engine, const Items &items, size_t begin, size_t end, DrawState &state){
+		engine.drawRange<ExactDispatch<T> >(items, begin, end, state);
+	}
+
+	template <class Calls, class Items>
+	void Engine::updateRange(const Items &items, size_t begin, size_t end){
+		for (size_t i = begin; i < end; i++) {
+			Element *item = items[i];
+			if (item->IsStoreBound()) continue;
+			item->SavePreviousState();
+			Calls::Move(item);
+		}
+	}
+
+	template <class Calls>
+	void Engine::drawAttached(Element *item, bool attached, const Transform &parentWorld){
+		if (!attached) {
+			Calls::Draw(item);
+			return;
+		}
+		float matrix[16];
+		parentWorld.ToMatrix(matrix);
+		glPushMatrix();
+		glMultMatrixf(matrix);		// Draw() then applies the local transform
+		Calls::Draw(item);
+		glPopMatrix();
+	}
+
+	template <class Calls, class Items>
+	void Engine::drawRange(const Items &items, size_t begin, size_t end, DrawState &state){
+		for (size_t i = begin; i < end; i++)
+		{
+			Element *item = items[i];
+			if (!item->IsShown()) continue;	// Hidden, no virtual calls at all
+			if (state.staticPass ? !item->isStatic : (item->isStatic && state.skipStatic)) continue;
+			if (state.blend) item->BeginInterpolation(state.alpha);
+			const bool attached = item->parent != NULL;
+			Transform parentWorld;
+			if (attached) parentWorld = sceneGraph.ParentWorld(item, state.blend ? state.alpha : 1.0f);
+			if (state.cull && !state.view.Overlaps(attached ? Calls::GetBounds(item).Transformed(parentWorld) : Calls::GetBounds(item))) {
+				if (state.blend) item->EndInterpolation();
+				continue;
+			}
+			state.drawn++;
+			if (state.timeTypes) {
+				const char *type = typeid(*item).name();
+				if (type != state.runType) {
+					const long long now = Clock::Ticks();
+					if (state.runType != NULL) profiler.Record(state.runType, state.runStart, now);
+					state.runType = type;
+					state.runStart = now;
+				}
+			}
+			if (Calls::HasBeforeDraw) Calls::BeforeDraw(item);
+			if (batching) {
+				renderBatch.SetTransform(attached ? parentWorld * item->GetTransform() : item->GetTransform());
+				if (!Calls::Submit(item, renderBatch)) {
+					renderBatch.Flush();	// Keep draw order for immediate-mode elements
+					drawAttached<Calls>(item, attached, parentWorld);
+				}
+			}
+			else drawAttached<Calls>(item, attached, parentWorld);
+			if (Calls::HasAfterDraw) Calls::AfterDraw(item);
+			if (state.blend) item->EndInterpolation();
+		}
+	}
 }
\ No newline at end of file
@@ -0,0 +1,76 @@
+///////////////////////////////////////////////////////////////////////////////
+/// GlFrameworkBasic is free software : you can redistribute it and or modify
+/// it under the terms of the GNU General Public License as published by
+/// the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// GlFrameworkBasic is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with GlFrameworkBasic. If not, see <http://www.gnu.org/licenses/>.
+///
+/// Author: Evan Edstrom
+/// Date: 11/17/2013
+/// Website: http://evanedstrom.com/glstart
+/// Email: contact@evanedstrom.com
+///
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include "FrameArena.h"
+
+namespace glFrameworkBasic {
+	FrameArena::FrameArena(size_t initialCapacity)
+	{
+		block = NULL;
+		capacity = initialCapacity < 256 ? 256 : initialCapacity;
+		offset = 0;
+		used = 0;
+		highWater = 0;
+	}
+
+	FrameArena::~FrameArena()
+	{
+		Reset();
+		delete[] block;
+	}
+
+	void *FrameArena::Allocate(size_t bytes, size_t alignment){
+		if (alignment < 1) alignment = 1;
+		if (block == NULL) block = new char[capacity];
+
+		const size_t address = (size_t)(block + offset);
+		const size_t padding = (alignment - (address & (alignment - 1))) & (alignment - 1);
+		if (offset + padding + bytes <= capacity) {
+			void *p = block + offset + padding;
+			offset += padding + bytes;
+			used += padding + bytes;
+			return p;
+		}
+
+		// Block is full. Overflow gets its own heap block, folded into the
+		// main one on the next Reset().
+		char *extra = new char[bytes + alignment];
+		overflow.push_back(extra);
+		used += bytes + alignment;
+		const size_t extraPadding = (alignment - ((size_t)extra & (alignment - 1))) & (alignment - 1);
+		return extra + extraPadding;
+	}
+
+	void FrameArena::Reset(){
+		if (used > highWater) highWater = used;
+		if (!overflow.empty()) {
+			for (size_t i = 0; i < overflow.size(); i++) delete[] overflow[i];
+			overflow.clear();
+			// Room for the whole high-water frame, with headroom for jitter.
+			delete[] block;
+			block = NULL;
+			capacity = highWater + highWater / 4;
+		}
+		offset = 0;
+		used = 0;
+	}
+}
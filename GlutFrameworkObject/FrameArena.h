@@ -0,0 +1,130 @@
+///////////////////////////////////////////////////////////////////////////////
+/// GlFrameworkBasic is free software : you can redistribute it and or modify
+/// it under the terms of the GNU General Public License as published by
+/// the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// GlFrameworkBasic is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with GlFrameworkBasic. If not, see <http://www.gnu.org/licenses/>.
+///
+/// Author: Evan Edstrom
+/// Date: 11/17/2013
+/// Website: http://evanedstrom.com/glstart
+/// Email: contact@evanedstrom.com
+///
+///////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace glFrameworkBasic {
+	/**
+	* FrameArena is a linear scratch allocator for data that lives for one
+	* frame. Allocate() bumps a pointer, nothing is freed individually, and
+	* Reset() at the start of the next frame releases everything at once.
+	* When the block runs out further requests go to overflow blocks; Reset()
+	* frees those and grows the block to the frame's high-water mark, so once
+	* frames are of steady size the arena stops touching the heap.
+	* Destructors are not run: keep to trivially destructible data, or use
+	* FrameAllocator with containers that are gone before Reset().
+	* Not thread safe, use one arena per thread.
+	*/
+	class FrameArena
+	{
+	public:
+		/// <summary>Creates an arena. The block is allocated on first use.</summary>
+		/// <param name="initialCapacity">Block size in bytes.</param>
+		explicit FrameArena(size_t initialCapacity = 64 * 1024);
+
+		/// <summary>Destructor. Frees every block.</summary>
+		~FrameArena();
+
+		/// <summary>Returns bytes of uninitialized memory aligned to alignment, a power of two.</summary>
+		void *Allocate(size_t bytes, size_t alignment = 16);
+
+		/// <summary>Returns uninitialized room for count objects of T.</summary>
+		template <class T>
+		T *Allocate(size_t count)
+		{
+			return (T *)Allocate(count * sizeof(T), std::alignment_of<T>::value);
+		}
+
+		/// <summary>
+		/// Releases everything allocated since the last reset. Grows the block
+		/// to the high-water mark when the last frame overflowed.
+		/// </summary>
+		void Reset();
+
+		/// <summary>Bytes handed out since the last reset, including alignment padding.</summary>
+		size_t Used() const { return used; }
+
+		/// <summary>Size of the block in bytes.</summary>
+		size_t Capacity() const { return capacity; }
+
+		/// <summary>Most bytes used in one frame so far.</summary>
+		size_t HighWater() const { return highWater; }
+
+	private:
+		char *block;
+		size_t capacity;
+		size_t offset;				// Next free byte in block
+		size_t used;
+		size_t highWater;
+		std::vector<char *> overflow;	// Blocks allocated after block filled up
+
+		// Copy is not allowed, the blocks are owned.
+		FrameArena(const FrameArena &);
+		FrameArena &operator=(const FrameArena &);
+	};
+
+	/**
+	* FrameAllocator lets standard containers draw from a FrameArena, for
+	* scratch vectors and maps that are built and dropped within a frame.
+	* Deallocation does nothing; the memory comes back on Reset().
+	*/
+	template <class T>
+	class FrameAllocator
+	{
+	public:
+		typedef T value_type;
+		typedef T *pointer;
+		typedef const T *const_pointer;
+		typedef T &reference;
+		typedef const T &const_reference;
+		typedef size_t size_type;
+		typedef ptrdiff_t difference_type;
+
+		template <class U>
+		struct rebind { typedef FrameAllocator<U> other; };
+
+		explicit FrameAllocator(FrameArena &frameArena) : arena(&frameArena) {}
+
+		template <class U>
+		FrameAllocator(const FrameAllocator<U> &other) : arena(other.arena) {}
+
+		T *allocate(size_t count) { return arena->Allocate<T>(count); }
+		void deallocate(T *, size_t) {}
+
+		template <class U, class V>
+		void construct(U *p, const V &value) { new ((void *)p) U(value); }
+
+		template <class U>
+		void destroy(U *p) { p->~U(); }
+
+		size_t max_size() const { return ((size_t)-1) / sizeof(T); }
+
+		bool operator==(const FrameAllocator &other) const { return arena == other.arena; }
+		bool operator!=(const FrameAllocator &other) const { return arena != other.arena; }
+
+		FrameArena *arena;
+	};
+}
@@ -0,0 +1,258 @@
+///////////////////////////////////////////////////////////////////////////////
+/// GlFrameworkBasic is free software : you can redistribute it and or modify
+/// it under the terms of the GNU General Public License as published by
+/// the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// GlFrameworkBasic is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with GlFrameworkBasic. If not, see <http://www.gnu.org/licenses/>.
+///
+/// Author: Evan Edstrom
+/// Date: 11/17/2013
+/// Website: http://evanedstrom.com/glstart
+/// Email: contact@evanedstrom.com
+///
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include "FrameCapture.h"
+#include "GlExtensions.h"
+
+namespace glFrameworkBasic {
+	FrameCapture::FrameCapture() : written(0), dropped(0)
+	{
+		active = false;
+		glReady = false;
+		usePixelBuffers = false;
+		for (int i = 0; i < RING_SIZE; i++) {
+			ring[i].buffer = 0;
+			ring[i].pixels = NULL;
+			ring[i].state = SLOT_FREE;
+		}
+		head = 0;
+		everyNth = 1;
+		frameIndex = 0;
+		width = 0; height = 0;
+		stopping = false;
+		format = FORMAT_RAW;
+		rateNumerator = 60; rateDenominator = 1;
+		headerWritten = false;
+	}
+
+	FrameCapture::~FrameCapture()
+	{
+		Stop();
+	}
+
+	bool FrameCapture::Start(const std::string &path, Format captureFormat, unsigned int nth,
+		unsigned int numerator, unsigned int denominator){
+		Stop();
+		out.open(path.c_str(), std::ios::binary | std::ios::trunc);
+		if (!out) return false;
+
+		format = captureFormat;
+		everyNth = nth > 0 ? nth : 1;
+		rateNumerator = numerator > 0 ? numerator : 60;
+		rateDenominator = denominator > 0 ? denominator : 1;
+		headerWritten = false;
+		frameIndex = 0;
+		glReady = false;
+		head = 0;
+		stopping = false;
+		written = 0;
+		dropped = 0;
+		active = true;
+		writer = std::thread(&FrameCapture::writerLoop, this);
+		return true;
+	}
+
+	void FrameCapture::initGL(int w, int h){
+		width = w;
+		height = h;
+		const size_t bytes = (size_t)width * height * 4;
+		usePixelBuffers = GlExtensions::HasPixelBuffers();
+		for (int i = 0; i < RING_SIZE; i++) {
+			Slot &slot = ring[i];
+			slot.state = SLOT_FREE;
+			if (usePixelBuffers) {
+				GlExtensions::GenBuffers(1, &slot.buffer);
+				GlExtensions::BindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+				GlExtensions::BufferData(GL_PIXEL_PACK_BUFFER, (GLsizeiptr)bytes, NULL, GL_STREAM_READ);
+			}
+			else slot.memory.resize(bytes);
+		}
+		if (usePixelBuffers) GlExtensions::BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+		glReady = true;
+	}
+
+	void FrameCapture::Capture(int w, int h){
+		if (!active) return;
+		if (frameIndex++ % everyNth != 0) return;
+		if (w <= 0 || h <= 0) return;
+		if (!glReady) initGL(w, h);
+		reclaim();
+		if (w != width || h != height) {
+			dropped++;
+			return;
+		}
+
+		// The oldest readback, issued RING_SIZE - 1 captures ago, is done by now.
+		Slot &oldest = ring[(head + 1) % RING_SIZE];
+		if (oldest.state == SLOT_READING) collect(oldest);
+
+		Slot &slot = ring[head];
+		if (slot.state != SLOT_FREE) {	// Writer is behind, keep drawing
+			dropped++;
+			return;
+		}
+		glPixelStorei(GL_PACK_ALIGNMENT, 1);
+		if (usePixelBuffers) {
+			GlExtensions::BindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+			glReadPixels(0, 0, width, height, GL_BGRA, GL_UNSIGNED_BYTE, NULL);	// Offset 0 into the buffer
+			GlExtensions::BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+			slot.state = SLOT_READING;
+		}
+		else {
+			glReadPixels(0, 0, width, height, GL_BGRA, GL_UNSIGNED_BYTE, &slot.memory[0]);
+			collect(slot);
+		}
+		head = (head + 1) % RING_SIZE;
+	}
+
+	void FrameCapture::reclaim(){
+		std::lock_guard<std::mutex> guard(lock);
+		for (int i = 0; i < RING_SIZE; i++) {
+			Slot &slot = ring[i];
+			if (slot.state != SLOT_DONE) continue;
+			if (usePixelBuffers) {
+				GlExtensions::BindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+				GlExtensions::UnmapBuffer(GL_PIXEL_PACK_BUFFER);
+				GlExtensions::BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+			}
+			slot.pixels = NULL;
+			slot.state = SLOT_FREE;
+		}
+	}
+
+	void FrameCapture::collect(Slot &slot){
+		const unsigned char *pixels = &slot.memory[0];
+		if (usePixelBuffers) {
+			GlExtensions::BindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+			pixels = (const unsigned char *)GlExtensions::MapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+			GlExtensions::BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+			if (pixels == NULL) {
+				slot.state = SLOT_FREE;
+				dropped++;
+				return;
+			}
+		}
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			slot.pixels = pixels;
+			slot.state = SLOT_WRITING;
+			queued.push_back(&slot);
+		}
+		wake.notify_one();
+	}
+
+	void FrameCapture::Stop(){
+		if (!active) return;
+		if (glReady) {
+			// Oldest first, so the file stays in frame order.
+			for (int i = 1; i <= RING_SIZE; i++) {
+				Slot &slot = ring[(head + i) % RING_SIZE];
+				if (slot.state == SLOT_READING) collect(slot);
+			}
+		}
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			stopping = true;
+		}
+		wake.notify_one();
+		writer.join();
+		out.close();
+
+		if (glReady) {
+			reclaim();
+			for (int i = 0; i < RING_SIZE; i++) {
+				if (ring[i].buffer != 0) GlExtensions::DeleteBuffers(1, &ring[i].buffer);
+				ring[i].buffer = 0;
+				std::vector<unsigned char>().swap(ring[i].memory);
+			}
+		}
+		glReady = false;
+		active = false;
+	}
+
+	void FrameCapture::writerLoop(){
+		std::unique_lock<std::mutex> guard(lock);
+		for (;;) {
+			wake.wait(guard, [this]() { return !queued.empty() || stopping; });
+			if (queued.empty()) break;	// Stopping and drained
+			Slot *slot = queued.front();
+			queued.pop_front();
+			guard.unlock();
+			writeFrame(slot->pixels);
+			guard.lock();
+			slot->state = SLOT_DONE;
+		}
+	}
+
+	void FrameCapture::writeFrame(const unsigned char *frame){
+		const size_t row = (size_t)width * 4;
+		if (format == FORMAT_RAW) {
+			// glReadPixels rows are bottom first, files are top first.
+			converted.resize(row);
+			for (int y = height - 1; y >= 0; y--) {
+				const unsigned char *src = &frame[y * row];
+				for (size_t x = 0; x < row; x += 4) {
+					converted[x] = src[x + 2];
+					converted[x + 1] = src[x + 1];
+					converted[x + 2] = src[x];
+					converted[x + 3] = src[x + 3];
+				}
+				out.write((const char *)&converted[0], row);
+			}
+		}
+		else {
+			if (!headerWritten) {
+				out << "YUV4MPEG2 W" << width << " H" << height << " F" << rateNumerator << ":" << rateDenominator
+					<< " Ip A1:1 C420jpeg\n";
+				headerWritten = true;
+			}
+			// BT.601 studio range, chroma averaged over 2x2 pixels.
+			const int chromaWidth = (width + 1) / 2, chromaHeight = (height + 1) / 2;
+			converted.resize((size_t)width * height + 2 * (size_t)chromaWidth * chromaHeight);
+			unsigned char *yPlane = &converted[0];
+			unsigned char *uPlane = yPlane + (size_t)width * height;
+			unsigned char *vPlane = uPlane + (size_t)chromaWidth * chromaHeight;
+			for (int y = 0; y < height; y++) {
+				const unsigned char *src = &frame[(height - 1 - y) * row];
+				unsigned char *dst = yPlane + (size_t)y * width;
+				for (int x = 0; x < width; x++, src += 4)
+					dst[x] = (unsigned char)(((66 * src[2] + 129 * src[1] + 25 * src[0] + 128) >> 8) + 16);
+			}
+			for (int cy = 0; cy < chromaHeight; cy++) {
+				const int y0 = 2 * cy, y1 = y0 + 1 < height ? y0 + 1 : y0;
+				const unsigned char *top = &frame[(height - 1 - y0) * row];
+				const unsigned char *bottom = &frame[(height - 1 - y1) * row];
+				for (int cx = 0; cx < chromaWidth; cx++) {
+					const int x0 = 8 * cx, x1 = 2 * cx + 1 < width ? x0 + 4 : x0;
+					const int b = top[x0] + top[x1] + bottom[x0] + bottom[x1];
+					const int g = top[x0 + 1] + top[x1 + 1] + bottom[x0 + 1] + bottom[x1 + 1];
+					const int r = top[x0 + 2] + top[x1 + 2] + bottom[x0 + 2] + bottom[x1 + 2];
+					uPlane[cy * chromaWidth + cx] = (unsigned char)(((-38 * r - 74 * g + 112 * b + 512) >> 10) + 128);
+					vPlane[cy * chromaWidth + cx] = (unsigned char)(((112 * r - 94 * g - 18 * b + 512) >> 10) + 128);
+				}
+			}
+			out << "FRAME\n";
+			out.write((const char *)&converted[0], converted.size());
+		}
+		written++;
+	}
+}
@@ -0,0 +1,158 @@
+///////////////////////////////////////////////////////////////////////////////
+/// GlFrameworkBasic is free software : you can redistribute it and or modify
+/// it under the terms of the GNU General Public License as published by
+/// the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// GlFrameworkBasic is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with GlFrameworkBasic. If not, see <http://www.gnu.org/licenses/>.
+///
+/// Author: Evan Edstrom
+/// Date: 11/17/2013
+/// Website: http://evanedstrom.com/glstart
+/// Email: contact@evanedstrom.com
+///
+///////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+#include <GL\glut.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace glFrameworkBasic {
+	/**
+	* FrameCapture records rendered frames to a file without stalling the GL
+	* thread. Capture() starts an asynchronous glReadPixels into one slot of a
+	* ring of pixel pack buffers. The slot read RING_SIZE - 1 captures earlier,
+	* which the driver has long finished, is mapped and handed as is to a
+	* writer thread that converts and streams it to disk; the GL thread unmaps
+	* it once the writer is done. When the writer falls behind and the next
+	* slot is still being written the frame is dropped and counted rather than
+	* blocking drawing, so memory stays bounded by the ring.
+	* Pixels are read as BGRA, the layout most drivers store, which skips a
+	* swizzle on the GL thread. Without pixel buffer support each slot is
+	* plain memory read synchronously; the writer still does the rest.
+	* Formats: raw RGBA rows top first, or Y4M (YUV 4:2:0, BT.601) which most
+	* video tools read directly.
+	*/
+	class FrameCapture
+	{
+	public:
+		enum Format {
+			FORMAT_RAW,		// Tightly packed RGBA frames, top row first
+			FORMAT_Y4M		// YUV4MPEG2 stream, 4:2:0 chroma
+		};
+
+		/// <summary>Frames in flight between readback and the file.</summary>
+		static const int RING_SIZE = 4;
+
+		FrameCapture();
+
+		/// <summary>Destructor. Stops a running capture.</summary>
+		~FrameCapture();
+
+		/// <summary>
+		/// Opens path and starts the writer thread. Every everyNth call to
+		/// Capture() records a frame. rateNumerator / rateDenominator is the
+		/// frame rate written to the Y4M header. Returns false if the file
+		/// cannot be created.
+		/// </summary>
+		bool Start(const std::string &path, Format format, unsigned int everyNth,
+			unsigned int rateNumerator, unsigned int rateDenominator);
+
+		/// <summary>
+		/// Records the current frame if it is due. Call with the frame drawn,
+		/// before swapping buffers. The frame size is fixed by the first
+		/// captured frame; frames of another size are dropped.
+		/// </summary>
+		void Capture(int width, int height);
+
+		/// <summary>
+		/// Writes the frames still in the ring, waits for the writer and
+		/// closes the file. Needs the capturing context current.
+		/// </summary>
+		void Stop();
+
+		/// <summary>True between Start() and Stop().</summary>
+		bool IsActive() const { return active; }
+
+		/// <summary>Frames written to the file so far.</summary>
+		unsigned int FramesWritten() const { return written.load(); }
+
+		/// <summary>Frames skipped because the writer was behind or the size changed.</summary>
+		unsigned int FramesDropped() const { return dropped.load(); }
+
+	private:
+		enum SlotState {
+			SLOT_FREE,
+			SLOT_READING,	// Readback issued, not mapped yet
+			SLOT_WRITING,	// Mapped and queued for the writer
+			SLOT_DONE		// Written, waiting to be unmapped
+		};
+
+		struct Slot {
+			GLuint buffer;						// Pixel pack buffer, 0 without pixel buffers
+			std::vector<unsigned char> memory;	// Used instead of buffer without pixel buffers
+			const unsigned char *pixels;		// BGRA, bottom row first, while writing
+			std::atomic<SlotState> state;		// The writer sets SLOT_DONE, the GL thread the rest
+		};
+
+		// GL thread state.
+		bool active;
+		bool glReady;			// Size fixed and slots made by the first capture
+		bool usePixelBuffers;
+		Slot ring[RING_SIZE];
+		int head;				// Slot the next readback goes to
+		unsigned int everyNth;
+		unsigned int frameIndex;
+		int width, height;
+
+		// Shared with the writer.
+		std::mutex lock;
+		std::condition_variable wake;
+		std::deque<Slot *> queued;		// Mapped slots waiting to be written, oldest first
+		bool stopping;
+
+		// Writer thread state.
+		std::thread writer;
+		std::ofstream out;
+		Format format;
+		unsigned int rateNumerator, rateDenominator;
+		bool headerWritten;
+		std::vector<unsigned char> converted;
+
+		std::atomic<unsigned int> written;
+		std::atomic<unsigned int> dropped;
+
+		/// <summary>Fixes the frame size and makes the slots.</summary>
+		void initGL(int width, int height);
+
+		/// <summary>Unmaps slots the writer has finished and frees them.</summary>
+		void reclaim();
+
+		/// <summary>Maps a read slot and queues it for the writer.</summary>
+		void collect(Slot &slot);
+
+		/// <summary>Writer thread body: writes queued slots until stopped and drained.</summary>
+		void writerLoop();
+
+		/// <summary>Converts and writes one frame. Writer thread only.</summary>
+		void writeFrame(const unsigned char *pixels);
+
+		// Copy is not allowed, the thread and GL objects are owned.
+		FrameCapture(const FrameCapture &);
+		FrameCapture &operator=(const FrameCapture &);
+	};
+}
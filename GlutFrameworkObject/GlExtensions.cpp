@@ -0,0 +1,150 @@
+///////////////////////////////////////////////////////////////////////////////
+/// GlFrameworkBasic is free software : you can redistribute it and or modify
+/// it under the terms of the GNU General Public License as published by
+/// the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// GlFrameworkBasic is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with GlFrameworkBasic. If not, see <http://www.gnu.org/licenses/>.
+///
+/// Author: Evan Edstrom
+/// Date: 11/17/2013
+/// Website: http://evanedstrom.com/glstart
+/// Email: contact@evanedstrom.com
+///
+///////////////////////////////////////////////////////////////////////////////
+
+
+#if defined(_WIN32)
+#include <windows.h>
+#endif
+#include "GlExtensions.h"
+#include <mutex>
+#include <string>
+
+#if defined(GLFRAMEWORK_HEADLESS_OSMESA)
+// OSMesa contexts resolve their own entry points, on every platform.
+#include <GL\osmesa.h>
+#define GLFRAMEWORK_GET_PROC(name) ((void *)OSMesaGetProcAddress(name))
+#elif defined(_WIN32)
+#define GLFRAMEWORK_GET_PROC(name) ((void *)wglGetProcAddress(name))
+#elif defined(GLFRAMEWORK_HEADLESS_EGL)
+#include <EGL\egl.h>
+#define GLFRAMEWORK_GET_PROC(name) ((void *)eglGetProcAddress(name))
+#else
+#include <GL\glx.h>
+#define GLFRAMEWORK_GET_PROC(name) ((void *)glXGetProcAddressARB((const GLubyte *)(name)))
+#endif
+
+namespace glFrameworkBasic {
+	namespace {
+		// Headless engines on several threads may load at once.
+		std::mutex loadLock;
+	}
+
+	std::atomic<bool> GlExtensions::loaded(false);
+	GlExtensions::GenFramebuffersProc GlExtensions::GenFramebuffers = NULL;
+	GlExtensions::DeleteFramebuffersProc GlExtensions::DeleteFramebuffers = NULL;
+	GlExtensions::BindFramebufferProc GlExtensions::BindFramebuffer = NULL;
+	GlExtensions::FramebufferTexture2DProc GlExtensions::FramebufferTexture2D = NULL;
+	GlExtensions::CheckFramebufferStatusProc GlExtensions::CheckFramebufferStatus = NULL;
+	GlExtensions::GenBuffersProc GlExtensions::GenBuffers = NULL;
+	GlExtensions::DeleteBuffersProc GlExtensions::DeleteBuffers = NULL;
+	GlExtensions::BindBufferProc GlExtensions::BindBuffer = NULL;
+	GlExtensions::BufferDataProc GlExtensions::BufferData = NULL;
+	GlExtensions::BufferSubDataProc GlExtensions::BufferSubData = NULL;
+	GlExtensions::MapBufferProc GlExtensions::MapBuffer = NULL;
+	GlExtensions::UnmapBufferProc GlExtensions::UnmapBuffer = NULL;
+	GlExtensions::CreateShaderProc GlExtensions::CreateShader = NULL;
+	GlExtensions::DeleteShaderProc GlExtensions::DeleteShader = NULL;
+	GlExtensions::ShaderSourceProc GlExtensions::ShaderSource = NULL;
+	GlExtensions::CompileShaderProc GlExtensions::CompileShader = NULL;
+	GlExtensions::GetShaderivProc GlExtensions::GetShaderiv = NULL;
+	GlExtensions::CreateProgramProc GlExtensions::CreateProgram = NULL;
+	GlExtensions::DeleteProgramProc GlExtensions::DeleteProgram = NULL;
+	GlExtensions::AttachShaderProc GlExtensions::AttachShader = NULL;
+	GlExtensions::BindAttribLocationProc GlExtensions::BindAttribLocation = NULL;
+	GlExtensions::LinkProgramProc GlExtensions::LinkProgram = NULL;
+	GlExtensions::GetProgramivProc GlExtensions::GetProgramiv = NULL;
+	GlExtensions::UseProgramProc GlExtensions::UseProgram = NULL;
+	GlExtensions::EnableVertexAttribArrayProc GlExtensions::EnableVertexAttribArray = NULL;
+	GlExtensions::DisableVertexAttribArrayProc GlExtensions::DisableVertexAttribArray = NULL;
+	GlExtensions::VertexAttribPointerProc GlExtensions::VertexAttribPointer = NULL;
+	GlExtensions::VertexAttribDivisorProc GlExtensions::VertexAttribDivisor = NULL;
+	GlExtensions::DrawArraysInstancedProc GlExtensions::DrawArraysInstanced = NULL;
+
+	void *GlExtensions::lookup(const char *name){
+		void *proc = GLFRAMEWORK_GET_PROC(name);
+		if (proc == NULL) proc = GLFRAMEWORK_GET_PROC((std::string(name) + "ARB").c_str());
+		if (proc == NULL) proc = GLFRAMEWORK_GET_PROC((std::string(name) + "EXT").c_str());
+		return proc;
+	}
+
+	bool GlExtensions::Load(){
+		// Checked every frame by many engines, so only the first load locks.
+		if (loaded.load(std::memory_order_acquire)) return true;
+		std::lock_guard<std::mutex> guard(loadLock);
+		if (loaded.load(std::memory_order_relaxed)) return true;
+		if (glGetString(GL_VERSION) == NULL) return false;	// No current context yet
+
+		GenFramebuffers = (GenFramebuffersProc)lookup("glGenFramebuffers");
+		DeleteFramebuffers = (DeleteFramebuffersProc)lookup("glDeleteFramebuffers");
+		BindFramebuffer = (BindFramebufferProc)lookup("glBindFramebuffer");
+		FramebufferTexture2D = (FramebufferTexture2DProc)lookup("glFramebufferTexture2D");
+		CheckFramebufferStatus = (CheckFramebufferStatusProc)lookup("glCheckFramebufferStatus");
+
+		GenBuffers = (GenBuffersProc)lookup("glGenBuffers");
+		DeleteBuffers = (DeleteBuffersProc)lookup("glDeleteBuffers");
+		BindBuffer = (BindBufferProc)lookup("glBindBuffer");
+		BufferData = (BufferDataProc)lookup("glBufferData");
+		BufferSubData = (BufferSubDataProc)lookup("glBufferSubData");
+		MapBuffer = (MapBufferProc)lookup("glMapBuffer");
+		UnmapBuffer = (UnmapBufferProc)lookup("glUnmapBuffer");
+
+		CreateShader = (CreateShaderProc)lookup("glCreateShader");
+		DeleteShader = (DeleteShaderProc)lookup("glDeleteShader");
+		ShaderSource = (ShaderSourceProc)lookup("glShaderSource");
+		CompileShader = (CompileShaderProc)lookup("glCompileShader");
+		GetShaderiv = (GetShaderivProc)lookup("glGetShaderiv");
+		CreateProgram = (CreateProgramProc)lookup("glCreateProgram");
+		DeleteProgram = (DeleteProgramProc)lookup("glDeleteProgram");
+		AttachShader = (AttachShaderProc)lookup("glAttachShader");
+		BindAttribLocation = (BindAttribLocationProc)lookup("glBindAttribLocation");
+		LinkProgram = (LinkProgramProc)lookup("glLinkProgram");
+		GetProgramiv = (GetProgramivProc)lookup("glGetProgramiv");
+		UseProgram = (UseProgramProc)lookup("glUseProgram");
+		EnableVertexAttribArray = (EnableVertexAttribArrayProc)lookup("glEnableVertexAttribArray");
+		DisableVertexAttribArray = (DisableVertexAttribArrayProc)lookup("glDisableVertexAttribArray");
+		VertexAttribPointer = (VertexAttribPointerProc)lookup("glVertexAttribPointer");
+
+		VertexAttribDivisor = (VertexAttribDivisorProc)lookup("glVertexAttribDivisor");
+		DrawArraysInstanced = (DrawArraysInstancedProc)lookup("glDrawArraysInstanced");
+		loaded.store(true, std::memory_order_release);	// Publishes the pointers above
+		return true;
+	}
+
+	bool GlExtensions::HasFramebuffers(){
+		return Load() && GenFramebuffers != NULL && DeleteFramebuffers != NULL && BindFramebuffer != NULL
+			&& FramebufferTexture2D != NULL && CheckFramebufferStatus != NULL;
+	}
+
+	bool GlExtensions::HasPixelBuffers(){
+		return Load() && GenBuffers != NULL && DeleteBuffers != NULL && BindBuffer != NULL
+			&& BufferData != NULL && MapBuffer != NULL && UnmapBuffer != NULL;
+	}
+
+	bool GlExtensions::HasInstancing(){
+		return Load() && GenBuffers != NULL && DeleteBuffers != NULL && BindBuffer != NULL
+			&& BufferData != NULL && BufferSubData != NULL
+			&& CreateShader != NULL && DeleteShader != NULL && ShaderSource != NULL && CompileShader != NULL
+			&& GetShaderiv != NULL && CreateProgram != NULL && DeleteProgram != NULL && AttachShader != NULL
+			&& BindAttribLocation != NULL && LinkProgram != NULL && GetProgramiv != NULL && UseProgram != NULL
+			&& EnableVertexAttribArray != NULL && DisableVertexAttribArray != NULL && VertexAttribPointer != NULL
+			&& VertexAttribDivisor != NULL && DrawArraysInstanced != NULL;
+	}
+}
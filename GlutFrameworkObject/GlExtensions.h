@@ -0,0 +1,176 @@
+///////////////////////////////////////////////////////////////////////////////
+/// GlFrameworkBasic is free software : you can redistribute it and or modify
+/// it under the terms of the GNU General Public License as published by
+/// the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// GlFrameworkBasic is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with GlFrameworkBasic. If not, see <http://www.gnu.org/licenses/>.
+///
+/// Author: Evan Edstrom
+/// Date: 11/17/2013
+/// Website: http://evanedstrom.com/glstart
+/// Email: contact@evanedstrom.com
+///
+///////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+#include <GL\glut.h>
+#include <atomic>
+
+// Framebuffer object tokens, missing from the OpenGL 1.1 headers on Windows.
+#ifndef GL_FRAMEBUFFER
+#define GL_FRAMEBUFFER 0x8D40
+#define GL_COLOR_ATTACHMENT0 0x8CE0
+#define GL_FRAMEBUFFER_COMPLETE 0x8CD5
+#endif
+#ifndef GL_CLAMP_TO_EDGE
+#define GL_CLAMP_TO_EDGE 0x812F
+#endif
+#ifndef GL_BGRA
+#define GL_BGRA 0x80E1
+#endif
+#ifndef APIENTRY
+#define APIENTRY
+#endif
+
+// Buffer object and shader types and tokens (GL 1.5 / 2.0), same story.
+#ifndef GL_VERSION_1_5
+#include <cstddef>
+typedef ptrdiff_t GLsizeiptr;
+typedef ptrdiff_t GLintptr;
+#endif
+#ifndef GL_VERSION_2_0
+typedef char GLchar;
+#endif
+#ifndef GL_ARRAY_BUFFER
+#define GL_ARRAY_BUFFER 0x8892
+#define GL_STREAM_DRAW 0x88E0
+#define GL_STATIC_DRAW 0x88E4
+#endif
+#ifndef GL_PIXEL_PACK_BUFFER
+#define GL_PIXEL_PACK_BUFFER 0x88EB
+#define GL_STREAM_READ 0x88E1
+#define GL_READ_ONLY 0x88B8
+#endif
+#ifndef GL_VERTEX_SHADER
+#define GL_FRAGMENT_SHADER 0x8B30
+#define GL_VERTEX_SHADER 0x8B31
+#define GL_COMPILE_STATUS 0x8B81
+#define GL_LINK_STATUS 0x8B82
+#endif
+
+namespace glFrameworkBasic {
+	/**
+	* GlExtensions loads the OpenGL entry points past version 1.1 that the
+	* framework uses, from the driver of the current context. The headers
+	* and import library shipped with Visual Studio stop at 1.1, so anything
+	* newer has to be fetched at run time (wglGetProcAddress on Windows,
+	* eglGetProcAddress for the EGL headless build, glXGetProcAddress otherwise).
+	* Load() must run with a context current. Check the Has functions before
+	* calling a group; missing entry points are NULL.
+	*/
+	class GlExtensions
+	{
+	public:
+		/// <summary>
+		/// Loads every entry point. Called once a context exists; later calls
+		/// return the first result.
+		/// </summary>
+		static bool Load();
+
+		/// <summary>True when framebuffer objects (GL 3.0, ARB or EXT) are available.</summary>
+		static bool HasFramebuffers();
+
+		/// <summary>
+		/// True when buffer objects, GLSL shaders and instanced arrays
+		/// (GL 3.3, or ARB_instanced_arrays) are all available.
+		/// </summary>
+		static bool HasInstancing();
+
+		/// <summary>True when buffer objects can be mapped and bound as pixel pack buffers (GL 2.1).</summary>
+		static bool HasPixelBuffers();
+
+		// Framebuffer objects.
+		typedef void (APIENTRY *GenFramebuffersProc)(GLsizei n, GLuint *framebuffers);
+		typedef void (APIENTRY *DeleteFramebuffersProc)(GLsizei n, const GLuint *framebuffers);
+		typedef void (APIENTRY *BindFramebufferProc)(GLenum target, GLuint framebuffer);
+		typedef void (APIENTRY *FramebufferTexture2DProc)(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level);
+		typedef GLenum (APIENTRY *CheckFramebufferStatusProc)(GLenum target);
+
+		static GenFramebuffersProc GenFramebuffers;
+		static DeleteFramebuffersProc DeleteFramebuffers;
+		static BindFramebufferProc BindFramebuffer;
+		static FramebufferTexture2DProc FramebufferTexture2D;
+		static CheckFramebufferStatusProc CheckFramebufferStatus;
+
+		// Buffer objects.
+		typedef void (APIENTRY *GenBuffersProc)(GLsizei n, GLuint *buffers);
+		typedef void (APIENTRY *DeleteBuffersProc)(GLsizei n, const GLuint *buffers);
+		typedef void (APIENTRY *BindBufferProc)(GLenum target, GLuint buffer);
+		typedef void (APIENTRY *BufferDataProc)(GLenum target, GLsizeiptr size, const void *data, GLenum usage);
+		typedef void (APIENTRY *BufferSubDataProc)(GLenum target, GLintptr offset, GLsizeiptr size, const void *data);
+		typedef void *(APIENTRY *MapBufferProc)(GLenum target, GLenum access);
+		typedef GLboolean (APIENTRY *UnmapBufferProc)(GLenum target);
+
+		static GenBuffersProc GenBuffers;
+		static DeleteBuffersProc DeleteBuffers;
+		static BindBufferProc BindBuffer;
+		static BufferDataProc BufferData;
+		static BufferSubDataProc BufferSubData;
+		static MapBufferProc MapBuffer;
+		static UnmapBufferProc UnmapBuffer;
+
+		// Shaders and vertex attributes.
+		typedef GLuint (APIENTRY *CreateShaderProc)(GLenum type);
+		typedef void (APIENTRY *DeleteShaderProc)(GLuint shader);
+		typedef void (APIENTRY *ShaderSourceProc)(GLuint shader, GLsizei count, const GLchar *const *source, const GLint *length);
+		typedef void (APIENTRY *CompileShaderProc)(GLuint shader);
+		typedef void (APIENTRY *GetShaderivProc)(GLuint shader, GLenum name, GLint *params);
+		typedef GLuint (APIENTRY *CreateProgramProc)();
+		typedef void (APIENTRY *DeleteProgramProc)(GLuint program);
+		typedef void (APIENTRY *AttachShaderProc)(GLuint program, GLuint shader);
+		typedef void (APIENTRY *BindAttribLocationProc)(GLuint program, GLuint index, const GLchar *name);
+		typedef void (APIENTRY *LinkProgramProc)(GLuint program);
+		typedef void (APIENTRY *GetProgramivProc)(GLuint program, GLenum name, GLint *params);
+		typedef void (APIENTRY *UseProgramProc)(GLuint program);
+		typedef void (APIENTRY *EnableVertexAttribArrayProc)(GLuint index);
+		typedef void (APIENTRY *DisableVertexAttribArrayProc)(GLuint index);
+		typedef void (APIENTRY *VertexAttribPointerProc)(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void *pointer);
+
+		static CreateShaderProc CreateShader;
+		static DeleteShaderProc DeleteShader;
+		static ShaderSourceProc ShaderSource;
+		static CompileShaderProc CompileShader;
+		static GetShaderivProc GetShaderiv;
+		static CreateProgramProc CreateProgram;
+		static DeleteProgramProc DeleteProgram;
+		static AttachShaderProc AttachShader;
+		static BindAttribLocationProc BindAttribLocation;
+		static LinkProgramProc LinkProgram;
+		static GetProgramivProc GetProgramiv;
+		static UseProgramProc UseProgram;
+		static EnableVertexAttribArrayProc EnableVertexAttribArray;
+		static DisableVertexAttribArrayProc DisableVertexAttribArray;
+		static VertexAttribPointerProc VertexAttribPointer;
+
+		// Instancing.
+		typedef void (APIENTRY *VertexAttribDivisorProc)(GLuint index, GLuint divisor);
+		typedef void (APIENTRY *DrawArraysInstancedProc)(GLenum mode, GLint first, GLsizei count, GLsizei instances);
+
+		static VertexAttribDivisorProc VertexAttribDivisor;
+		static DrawArraysInstancedProc DrawArraysInstanced;
+
+	private:
+		static std::atomic<bool> loaded;
+
+		/// <summary>Looks up name, then name with the ARB and EXT suffixes.</summary>
+		static void *lookup(const char *name);
+	};
+}
@@ -0,0 +1,48 @@
+///////////////////////////////////////////////////////////////////////////////
+/// GlFrameworkBasic is free software : you can redistribute it and or modify
+/// it under the terms of the GNU General Public License as published by
+/// the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// GlFrameworkBasic is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with GlFrameworkBasic. If not, see <http://www.gnu.org/licenses/>.
+///
+/// Author: Evan Edstrom
+/// Date: 11/17/2013
+/// Website: http://evanedstrom.com/glstart
+/// Email: contact@evanedstrom.com
+///
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include "HeadlessBatch.h"
+#include "Engine.h"
+
+namespace glFrameworkBasic {
+	HeadlessBatch::HeadlessBatch(int workerCount) : jobs(workerCount)
+	{
+	}
+
+	void HeadlessBatch::Run(size_t count, const Factory &factory, const Collect &collect){
+		// One job per engine: runs are long, so stealing balances them well
+		// enough without chunking.
+		for (size_t i = 0; i < count; i++) {
+			jobs.Schedule([&factory, &collect, i]() {
+				Engine *engine = factory(i);
+				if (engine == NULL) return;
+				engine->SetBackend(Engine::BACKEND_HEADLESS);
+				char name[] = "HeadlessBatch";
+				char *argv[] = { name, NULL };
+				engine->Begin(1, argv);
+				if (collect) collect(i, *engine);
+				delete engine;
+			});
+		}
+		jobs.Wait();
+	}
+}
@@ -0,0 +1,73 @@
+///////////////////////////////////////////////////////////////////////////////
+/// GlFrameworkBasic is free software : you can redistribute it and or modify
+/// it under the terms of the GNU General Public License as published by
+/// the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// GlFrameworkBasic is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with GlFrameworkBasic. If not, see <http://www.gnu.org/licenses/>.
+///
+/// Author: Evan Edstrom
+/// Date: 11/17/2013
+/// Website: http://evanedstrom.com/glstart
+/// Email: contact@evanedstrom.com
+///
+///////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+#include <cstddef>
+#include <functional>
+
+#include "JobSystem.h"
+
+namespace glFrameworkBasic {
+	class Engine;
+
+	/**
+	* HeadlessBatch runs many independent headless engines on a thread pool,
+	* for parameter sweeps and batch simulation. Each run creates its engine
+	* on a pool thread, calls Begin() there (so the offscreen context is
+	* current on that thread for the whole run), hands the finished engine to
+	* a collect callback and deletes it. Runs share no state, so throughput
+	* grows with the number of cores.
+	*/
+	class HeadlessBatch
+	{
+	public:
+		/// <summary>Makes the engine for run index. Set its frame limit or call Stop() from it.</summary>
+		typedef std::function<Engine *(size_t index)> Factory;
+
+		/// <summary>Reads results from a finished engine. Called on pool threads, concurrently.</summary>
+		typedef std::function<void(size_t index, Engine &engine)> Collect;
+
+		/// <summary>
+		/// Starts workerCount threads. Default (-1) uses one less than the
+		/// number of hardware threads; the thread calling Run() makes up the rest.
+		/// </summary>
+		explicit HeadlessBatch(int workerCount = -1);
+
+		/// <summary>
+		/// Runs count engines made by factory, each headless until its frame
+		/// limit or Stop(), and calls collect (if set) after each one. Returns
+		/// when all runs are done. Engines that use SetParallelUpdate() or
+		/// SetPipelined() start their own job systems on top of this pool.
+		/// </summary>
+		void Run(size_t count, const Factory &factory, const Collect &collect);
+
+		/// <summary>Threads running engines, not counting the caller of Run().</summary>
+		int WorkerCount() const { return jobs.WorkerCount(); }
+
+	private:
+		JobSystem jobs;
+
+		// Copy is not allowed, the pool is owned.
+		HeadlessBatch(const HeadlessBatch &);
+		HeadlessBatch &operator=(const HeadlessBatch &);
+	};
+}
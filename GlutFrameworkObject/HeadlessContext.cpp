@@ -0,0 +1,162 @@
+///////////////////////////////////////////////////////////////////////////////
+/// GlFrameworkBasic is free software : you can redistribute it and or modify
+/// it under the terms of the GNU General Public License as published by
+/// the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// GlFrameworkBasic is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with GlFrameworkBasic. If not, see <http://www.gnu.org/licenses/>.
+///
+/// Author: Evan Edstrom
+/// Date: 11/17/2013
+/// Website: http://evanedstrom.com/glstart
+/// Email: contact@evanedstrom.com
+///
+///////////////////////////////////////////////////////////////////////////////
+
+#include "HeadlessContext.h"
+
+#if defined(GLFRAMEWORK_HEADLESS_OSMESA)
+#include <GL\osmesa.h>
+#elif defined(GLFRAMEWORK_HEADLESS_EGL)
+#include <EGL\egl.h>
+#ifndef EGL_PLATFORM_SURFACELESS_MESA
+#define EGL_PLATFORM_SURFACELESS_MESA 0x31DD
+#endif
+#include <mutex>
+#endif
+
+namespace glFrameworkBasic {
+#if defined(GLFRAMEWORK_HEADLESS_EGL)
+	namespace {
+		// Contexts on every thread share one EGLDisplay, and eglTerminate()
+		// would destroy all of them. Terminate when the last one goes.
+		std::mutex displayLock;
+		int displayUsers = 0;
+
+		bool acquireDisplay(EGLDisplay dpy){
+			std::lock_guard<std::mutex> guard(displayLock);
+			if (displayUsers == 0 && !eglInitialize(dpy, NULL, NULL)) return false;
+			displayUsers++;
+			return true;
+		}
+
+		void releaseDisplay(EGLDisplay dpy){
+			std::lock_guard<std::mutex> guard(displayLock);
+			if (--displayUsers == 0) eglTerminate(dpy);
+		}
+	}
+#endif
+
+	HeadlessContext::HeadlessContext()
+	{
+		width = 0; height = 0;
+		created = false;
+		display = NULL; surface = NULL; context = NULL;
+	}
+
+	HeadlessContext::~HeadlessContext()
+	{
+		Destroy();
+	}
+
+	bool HeadlessContext::Create(int w, int h){
+		Destroy();
+		if (w <= 0) w = 1;
+		if (h <= 0) h = 1;
+		width = w;
+		height = h;
+
+#if defined(GLFRAMEWORK_HEADLESS_OSMESA)
+		// OSMesa draws straight into our buffer, no readback needed.
+		framebuffer.assign((size_t)width * height * 4, 0);
+		OSMesaContext ctx = OSMesaCreateContextExt(OSMESA_RGBA, 16, 0, 0, NULL);
+		if (ctx == NULL) return false;
+		if (!OSMesaMakeCurrent(ctx, &framebuffer[0], GL_UNSIGNED_BYTE, width, height)) {
+			OSMesaDestroyContext(ctx);
+			return false;
+		}
+		context = ctx;
+		created = true;
+#elif defined(GLFRAMEWORK_HEADLESS_EGL)
+		// Prefer Mesa's surfaceless platform so no X server is required.
+		typedef EGLDisplay(EGLAPIENTRY *GetPlatformDisplayProc)(EGLenum, void *, const EGLint *);
+		GetPlatformDisplayProc getPlatformDisplay =
+			(GetPlatformDisplayProc)eglGetProcAddress("eglGetPlatformDisplayEXT");
+		EGLDisplay dpy = EGL_NO_DISPLAY;
+		if (getPlatformDisplay != NULL)
+			dpy = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+		if (dpy == EGL_NO_DISPLAY)
+			dpy = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+		if (dpy == EGL_NO_DISPLAY || !acquireDisplay(dpy)) return false;
+
+		const EGLint configAttribs[] = {
+			EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+			EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+			EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8, EGL_ALPHA_SIZE, 8,
+			EGL_NONE
+		};
+		EGLConfig config;
+		EGLint numConfigs = 0;
+		if (!eglChooseConfig(dpy, configAttribs, &config, 1, &numConfigs) || numConfigs < 1) {
+			releaseDisplay(dpy);
+			return false;
+		}
+
+		const EGLint surfaceAttribs[] = { EGL_WIDTH, width, EGL_HEIGHT, height, EGL_NONE };
+		EGLSurface surf = eglCreatePbufferSurface(dpy, config, surfaceAttribs);
+		eglBindAPI(EGL_OPENGL_API);
+		EGLContext ctx = eglCreateContext(dpy, config, EGL_NO_CONTEXT, NULL);
+		if (surf == EGL_NO_SURFACE || ctx == EGL_NO_CONTEXT || !eglMakeCurrent(dpy, surf, surf, ctx)) {
+			if (ctx != EGL_NO_CONTEXT) eglDestroyContext(dpy, ctx);
+			if (surf != EGL_NO_SURFACE) eglDestroySurface(dpy, surf);
+			releaseDisplay(dpy);
+			return false;
+		}
+		display = dpy; surface = surf; context = ctx;
+		created = true;
+#endif
+		return created;
+	}
+
+	void HeadlessContext::Destroy(){
+		if (created) {
+#if defined(GLFRAMEWORK_HEADLESS_OSMESA)
+			OSMesaDestroyContext((OSMesaContext)context);
+#elif defined(GLFRAMEWORK_HEADLESS_EGL)
+			eglMakeCurrent((EGLDisplay)display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+			eglDestroyContext((EGLDisplay)display, (EGLContext)context);
+			eglDestroySurface((EGLDisplay)display, (EGLSurface)surface);
+			releaseDisplay((EGLDisplay)display);
+#endif
+		}
+		created = false;
+		display = NULL; surface = NULL; context = NULL;
+		framebuffer.clear();
+	}
+
+	bool HeadlessContext::IsCreated() const {
+		return created;
+	}
+
+	void HeadlessContext::Finish(){
+		if (created) glFinish();
+	}
+
+	const std::vector<unsigned char> &HeadlessContext::ReadFramebuffer(){
+		if (!created) return framebuffer;
+		glFinish();
+#if !defined(GLFRAMEWORK_HEADLESS_OSMESA)
+		// Pbuffer contents live on the GL side, copy them out.
+		framebuffer.resize((size_t)width * height * 4);
+		glPixelStorei(GL_PACK_ALIGNMENT, 1);
+		glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, &framebuffer[0]);
+#endif
+		return framebuffer;
+	}
+}
@@ -0,0 +1,84 @@
+///////////////////////////////////////////////////////////////////////////////
+/// GlFrameworkBasic is free software : you can redistribute it and or modify
+/// it under the terms of the GNU General Public License as published by
+/// the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// GlFrameworkBasic is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with GlFrameworkBasic. If not, see <http://www.gnu.org/licenses/>.
+///
+/// Author: Evan Edstrom
+/// Date: 11/17/2013
+/// Website: http://evanedstrom.com/glstart
+/// Email: contact@evanedstrom.com
+///
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <GL\glut.h>
+#include <vector>
+
+namespace glFrameworkBasic {
+	/**
+	* HeadlessContext owns an offscreen OpenGL context that renders into a
+	* CPU side framebuffer, so the Engine can run without GLUT or a display.
+	* The context provider is chosen at compile time:
+	* - GLFRAMEWORK_HEADLESS_OSMESA renders straight into system memory with OSMesa,
+	* - GLFRAMEWORK_HEADLESS_EGL renders into an EGL pbuffer (llvmpipe, or a GPU).
+	* With neither defined Create() fails and the Engine runs simulation only;
+	* GL calls made without a current context are ignored by the driver.
+	*/
+	class HeadlessContext
+	{
+	public:
+		/// <summary>Initializes an empty, not yet created context.</summary>
+		HeadlessContext();
+
+		/// <summary>Destructor. Releases the context if it is still alive.</summary>
+		~HeadlessContext();
+
+		/// <summary>
+		/// Creates the offscreen context and makes it current on the calling thread.
+		/// Returns false if no offscreen provider was compiled in or it failed.
+		/// </summary>
+		bool Create(int width, int height);
+
+		/// <summary>Releases the context and the framebuffer.</summary>
+		void Destroy();
+
+		/// <summary>True when a context was created and is current.</summary>
+		bool IsCreated() const;
+
+		/// <summary>Waits for all submitted GL work to finish.</summary>
+		void Finish();
+
+		/// <summary>
+		/// Returns the last rendered frame as tightly packed RGBA rows, bottom row
+		/// first (the glReadPixels layout). Empty when no context exists.
+		/// </summary>
+		const std::vector<unsigned char> &ReadFramebuffer();
+
+		int GetWidth() const { return width; }
+		int GetHeight() const { return height; }
+
+	private:
+		int width, height;
+		bool created;
+		std::vector<unsigned char> framebuffer;
+
+		// Provider specific handles. Kept opaque so this header does not
+		// pull in osmesa.h or egl.h.
+		void *display;
+		void *surface;
+		void *context;
+
+		// Copy is not allowed, the context handles are owned.
+		HeadlessContext(const HeadlessContext &);
+		HeadlessContext &operator=(const HeadlessContext &);
+	};
+}
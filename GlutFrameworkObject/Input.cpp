@@ -0,0 +1,116 @@
+///////////////////////////////////////////////////////////////////////////////
+/// GlFrameworkBasic is free software : you can redistribute it and or modify
+/// it under the terms of the GNU General Public License as published by
+/// the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// GlFrameworkBasic is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with GlFrameworkBasic. If not, see <http://www.gnu.org/licenses/>.
+///
+/// Author: Evan Edstrom
+/// Date: 11/17/2013
+/// Website: http://evanedstrom.com/glstart
+/// Email: contact@evanedstrom.com
+///
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include "Input.h"
+#include "Clock.h"
+
+namespace glFrameworkBasic {
+	Input::Input()
+	{
+		mouseX = 0;
+		mouseY = 0;
+	}
+
+	void Input::Push(InputEvent::Type type, int code, int x, int y){
+		InputEvent event;
+		event.type = type;
+		event.code = code;
+		event.x = x;
+		event.y = y;
+		event.time = (double)Clock::Ticks() / (double)Clock::TicksPerSecond();
+		Push(event);
+	}
+
+	void Input::Push(const InputEvent &event){
+		// Motion only matters as the latest position, merge runs of it.
+		if (event.type == InputEvent::MOUSE_MOVE && !pending.empty()
+			&& pending.back().type == InputEvent::MOUSE_MOVE) {
+			pending.back() = event;
+			return;
+		}
+		pending.push_back(event);
+	}
+
+	void Input::BeginFrame(){
+		pressed.reset();
+		released.reset();
+		buttonsPressed.reset();
+		buttonsReleased.reset();
+
+		// Swap keeps both vectors' capacity, no allocation per frame.
+		frameEvents.swap(pending);
+		pending.clear();
+		for (size_t i = 0; i < frameEvents.size(); i++)
+			apply(frameEvents[i]);
+	}
+
+	void Input::apply(const InputEvent &event){
+		int key = event.code;
+		switch (event.type) {
+		case InputEvent::SPECIAL_DOWN:
+			key = SpecialKey(event.code);	// Fall through
+		case InputEvent::KEY_DOWN:
+			if (!valid(key, NUMBER_KEYS)) break;
+			if (!down[key]) pressed[key] = true;	// Ignore key repeat
+			down[key] = true;
+			break;
+		case InputEvent::SPECIAL_UP:
+			key = SpecialKey(event.code);	// Fall through
+		case InputEvent::KEY_UP:
+			if (!valid(key, NUMBER_KEYS)) break;
+			if (down[key]) released[key] = true;
+			down[key] = false;
+			break;
+		case InputEvent::MOUSE_DOWN:
+			if (valid(event.code, NUMBER_BUTTONS)) {
+				buttonsPressed[event.code] = true;
+				buttonsDown[event.code] = true;
+			}
+			mouseX = event.x;
+			mouseY = event.y;
+			break;
+		case InputEvent::MOUSE_UP:
+			if (valid(event.code, NUMBER_BUTTONS)) {
+				buttonsReleased[event.code] = true;
+				buttonsDown[event.code] = false;
+			}
+			mouseX = event.x;
+			mouseY = event.y;
+			break;
+		case InputEvent::MOUSE_MOVE:
+			mouseX = event.x;
+			mouseY = event.y;
+			break;
+		}
+	}
+
+	void Input::Clear(){
+		pending.clear();
+		frameEvents.clear();
+		down.reset();
+		pressed.reset();
+		released.reset();
+		buttonsDown.reset();
+		buttonsPressed.reset();
+		buttonsReleased.reset();
+	}
+}
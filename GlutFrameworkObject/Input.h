@@ -0,0 +1,119 @@
+///////////////////////////////////////////////////////////////////////////////
+/// GlFrameworkBasic is free software : you can redistribute it and or modify
+/// it under the terms of the GNU General Public License as published by
+/// the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// GlFrameworkBasic is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with GlFrameworkBasic. If not, see <http://www.gnu.org/licenses/>.
+///
+/// Author: Evan Edstrom
+/// Date: 11/17/2013
+/// Website: http://evanedstrom.com/glstart
+/// Email: contact@evanedstrom.com
+///
+///////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+#include <bitset>
+#include <vector>
+
+namespace glFrameworkBasic {
+	/// <summary>One input callback, stamped when GLUT delivered it.</summary>
+	struct InputEvent
+	{
+		enum Type {
+			KEY_DOWN, KEY_UP,			// code is the ASCII key
+			SPECIAL_DOWN, SPECIAL_UP,	// code is a GLUT_KEY_* value
+			MOUSE_DOWN, MOUSE_UP,		// code is a GLUT_*_BUTTON value
+			MOUSE_MOVE					// code unused, x and y hold the position
+		};
+
+		Type type;
+		int code;
+		int x, y;		// Mouse position in window pixels at the event
+		double time;	// Seconds on the Clock::Ticks() timeline
+	};
+
+	/**
+	* Input queues timestamped keyboard, special key and mouse events as GLUT
+	* delivers them and hands them to the game in one batch per frame.
+	* BeginFrame() applies the queued events in order, so a key pressed and
+	* released between two frames still reports WasPressed() and WasReleased()
+	* for that frame even though it is no longer down. Consecutive mouse
+	* motion events are coalesced into the latest position.
+	* Keys and special keys share one code space: ASCII keys are 0-255 and
+	* special keys are SPECIAL_BASE + GLUT_KEY_*, see SpecialKey().
+	*/
+	class Input
+	{
+	public:
+		static const int SPECIAL_BASE = 256;
+		static const int NUMBER_KEYS = 512;
+		static const int NUMBER_BUTTONS = 8;
+
+		/// <summary>Code of a GLUT_KEY_* special key in the shared key space.</summary>
+		static int SpecialKey(int glutKey) { return SPECIAL_BASE + glutKey; }
+
+		/// <summary>Initializes all keys and buttons up, mouse at 0, 0.</summary>
+		Input();
+
+		/// <summary>Queues an event from a GLUT callback. time is stamped now.</summary>
+		void Push(InputEvent::Type type, int code, int x, int y);
+
+		/// <summary>Queues an event with a given time, for replaying recorded input.</summary>
+		void Push(const InputEvent &event);
+
+		/// <summary>
+		/// Delivers the events queued since the last call: clears the edge bits
+		/// and applies every event in order. Engine calls this before display().
+		/// </summary>
+		void BeginFrame();
+
+		/// <summary>Events delivered by the last BeginFrame(), oldest first.</summary>
+		const std::vector<InputEvent> &Events() const { return frameEvents; }
+
+		/// <summary>True while the key is held. Use SpecialKey() for special keys.</summary>
+		bool IsDown(int key) const { return valid(key, NUMBER_KEYS) && down[key]; }
+
+		/// <summary>True if the key went down at least once this frame.</summary>
+		bool WasPressed(int key) const { return valid(key, NUMBER_KEYS) && pressed[key]; }
+
+		/// <summary>True if the key went up at least once this frame.</summary>
+		bool WasReleased(int key) const { return valid(key, NUMBER_KEYS) && released[key]; }
+
+		/// <summary>True while the GLUT mouse button is held.</summary>
+		bool IsButtonDown(int button) const { return valid(button, NUMBER_BUTTONS) && buttonsDown[button]; }
+
+		/// <summary>True if the mouse button went down at least once this frame.</summary>
+		bool WasButtonPressed(int button) const { return valid(button, NUMBER_BUTTONS) && buttonsPressed[button]; }
+
+		/// <summary>True if the mouse button went up at least once this frame.</summary>
+		bool WasButtonReleased(int button) const { return valid(button, NUMBER_BUTTONS) && buttonsReleased[button]; }
+
+		/// <summary>Mouse position in window pixels after this frame's events.</summary>
+		int MouseX() const { return mouseX; }
+		int MouseY() const { return mouseY; }
+
+		/// <summary>Drops queued events and releases every key and button.</summary>
+		void Clear();
+
+	private:
+		std::vector<InputEvent> pending;		// Queued since the last BeginFrame()
+		std::vector<InputEvent> frameEvents;	// Delivered this frame
+		std::bitset<NUMBER_KEYS> down, pressed, released;
+		std::bitset<NUMBER_BUTTONS> buttonsDown, buttonsPressed, buttonsReleased;
+		int mouseX, mouseY;
+
+		static bool valid(int code, int count) { return code >= 0 && code < count; }
+
+		/// <summary>Updates the state bits for one event.</summary>
+		void apply(const InputEvent &event);
+	};
+}
@@ -0,0 +1,134 @@
+///////////////////////////////////////////////////////////////////////////////
+/// GlFrameworkBasic is free software : you can redistribute it and or modify
+/// it under the terms of the GNU General Public License as published by
+/// the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// GlFrameworkBasic is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with GlFrameworkBasic. If not, see <http://www.gnu.org/licenses/>.
+///
+/// Author: Evan Edstrom
+/// Date: 11/17/2013
+/// Website: http://evanedstrom.com/glstart
+/// Email: contact@evanedstrom.com
+///
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include "InputLog.h"
+#include <cstring>
+
+namespace glFrameworkBasic {
+	InputLog::InputLog()
+	{
+		timestep = 0.0;
+	}
+
+	InputLog::~InputLog()
+	{
+		Close();
+	}
+
+	bool InputLog::OpenWrite(const std::string &path, double step){
+		Close();
+		out.open(path.c_str(), std::ios::binary | std::ios::trunc);
+		if (!out.is_open()) return false;
+		timestep = step;
+
+		writeBytes("GLIN", 4);
+		unsigned char version[4] = { VERSION & 0xff, 0, 0, 0 };
+		writeBytes(version, 4);
+		writeBytes(&timestep, sizeof(timestep));	// IEEE double, x86 byte order
+		return true;
+	}
+
+	bool InputLog::OpenRead(const std::string &path){
+		Close();
+		in.open(path.c_str(), std::ios::binary);
+		if (!in.is_open()) return false;
+
+		char magic[4];
+		unsigned char version[4];
+		if (!readBytes(magic, 4) || memcmp(magic, "GLIN", 4) != 0
+			|| !readBytes(version, 4) || version[0] != VERSION
+			|| !readBytes(&timestep, sizeof(timestep))) {
+			Close();
+			return false;
+		}
+		return true;
+	}
+
+	void InputLog::Close(){
+		if (out.is_open()) out.close();
+		if (in.is_open()) in.close();
+		in.clear();
+	}
+
+	void InputLog::WriteEvent(const InputLogEvent &event){
+		if (!IsWriting()) return;
+		unsigned char header[2] = { (unsigned char)(1 + event.type), (unsigned char)(event.drag ? 1 : 0) };
+		writeBytes(header, 2);
+		writeU16((unsigned int)event.code);
+		writeU16((unsigned int)event.x);
+		writeU16((unsigned int)event.y);
+	}
+
+	void InputLog::WriteFrame(int steps){
+		if (!IsWriting()) return;
+		unsigned char kind = 0;
+		writeBytes(&kind, 1);
+		writeU16((unsigned int)steps);
+		out.flush();	// exit() from a key handler must not lose the tail
+	}
+
+	bool InputLog::ReadFrame(std::vector<InputLogEvent> &events, int &steps){
+		events.clear();
+		if (!IsReading()) return false;
+		unsigned char kind;
+		while (readBytes(&kind, 1)) {
+			if (kind == 0) {
+				unsigned int count;
+				if (!readU16(count)) return false;
+				steps = (int)count;
+				return true;
+			}
+			unsigned char drag;
+			unsigned int code, x, y;
+			if (!readBytes(&drag, 1) || !readU16(code) || !readU16(x) || !readU16(y)) return false;
+			InputLogEvent event;
+			event.type = (InputEvent::Type)(kind - 1);
+			event.drag = drag != 0;
+			event.code = (short)code;	// Sign extend
+			event.x = (short)x;
+			event.y = (short)y;
+			events.push_back(event);
+		}
+		return false;	// Events after the last frame never ran
+	}
+
+	void InputLog::writeBytes(const void *data, size_t size){
+		out.write((const char *)data, size);
+	}
+
+	bool InputLog::readBytes(void *data, size_t size){
+		in.read((char *)data, size);
+		return (size_t)in.gcount() == size;
+	}
+
+	void InputLog::writeU16(unsigned int value){
+		unsigned char bytes[2] = { (unsigned char)(value & 0xff), (unsigned char)((value >> 8) & 0xff) };
+		writeBytes(bytes, 2);
+	}
+
+	bool InputLog::readU16(unsigned int &value){
+		unsigned char bytes[2];
+		if (!readBytes(bytes, 2)) return false;
+		value = bytes[0] | (bytes[1] << 8);
+		return true;
+	}
+}
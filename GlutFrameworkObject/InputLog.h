@@ -0,0 +1,101 @@
+///////////////////////////////////////////////////////////////////////////////
+/// GlFrameworkBasic is free software : you can redistribute it and or modify
+/// it under the terms of the GNU General Public License as published by
+/// the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// GlFrameworkBasic is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with GlFrameworkBasic. If not, see <http://www.gnu.org/licenses/>.
+///
+/// Author: Evan Edstrom
+/// Date: 11/17/2013
+/// Website: http://evanedstrom.com/glstart
+/// Email: contact@evanedstrom.com
+///
+///////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "Input.h"
+
+namespace glFrameworkBasic {
+	/// <summary>One recorded input callback.</summary>
+	struct InputLogEvent
+	{
+		InputEvent::Type type;
+		bool drag;		// MOUSE_MOVE with a button held (glutMotionFunc)
+		int code;
+		int x, y;
+	};
+
+	/**
+	* InputLog reads and writes the compact binary input recordings used by
+	* Engine record / replay. A log is a small header followed by, for every
+	* frame, the input callbacks that arrived before it and then the number
+	* of update steps that frame ran. Replaying the events before the same
+	* step counts reproduces the simulation exactly.
+	* Layout, little endian: "GLIN", u32 version, f64 timestep; then records
+	* of u8 kind: 0 frame (u16 steps), 1 + InputEvent::Type event
+	* (u8 drag, i16 code, i16 x, i16 y).
+	*/
+	class InputLog
+	{
+	public:
+		InputLog();
+
+		/// <summary>Destructor. Closes the file.</summary>
+		~InputLog();
+
+		/// <summary>Creates a log for writing. Returns false if the file cannot be opened.</summary>
+		bool OpenWrite(const std::string &path, double timestep);
+
+		/// <summary>Opens a log for reading. Returns false if it is missing or not a log.</summary>
+		bool OpenRead(const std::string &path);
+
+		/// <summary>Flushes and closes the file.</summary>
+		void Close();
+
+		bool IsWriting() const { return out.is_open(); }
+		bool IsReading() const { return in.is_open(); }
+
+		/// <summary>Timestep stored in the header.</summary>
+		double Timestep() const { return timestep; }
+
+		/// <summary>Appends one input callback.</summary>
+		void WriteEvent(const InputLogEvent &event);
+
+		/// <summary>Ends the current frame with its step count and flushes.</summary>
+		void WriteFrame(int steps);
+
+		/// <summary>
+		/// Reads the next frame: its events, oldest first, and step count.
+		/// Returns false at the end of the log.
+		/// </summary>
+		bool ReadFrame(std::vector<InputLogEvent> &events, int &steps);
+
+	private:
+		std::ofstream out;
+		std::ifstream in;
+		double timestep;
+
+		static const unsigned int VERSION = 1;
+
+		void writeBytes(const void *data, size_t size);
+		bool readBytes(void *data, size_t size);
+		void writeU16(unsigned int value);
+		bool readU16(unsigned int &value);
+
+		// Copy is not allowed, the file is owned.
+		InputLog(const InputLog &);
+		InputLog &operator=(const InputLog &);
+	};
+}
@@ -0,0 +1,225 @@
+///////////////////////////////////////////////////////////////////////////////
+/// GlFrameworkBasic is free software : you can redistribute it and or modify
+/// it under the terms of the GNU General Public License as published by
+/// the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// GlFrameworkBasic is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with GlFrameworkBasic. If not, see <http://www.gnu.org/licenses/>.
+///
+/// Author: Evan Edstrom
+/// Date: 11/17/2013
+/// Website: http://evanedstrom.com/glstart
+/// Email: contact@evanedstrom.com
+///
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include "InstanceRenderer.h"
+#include "GlExtensions.h"
+#include <vector>
+
+namespace glFrameworkBasic {
+	namespace {
+		// Attribute locations, bound before linking. Position must be 0 so
+		// compatibility contexts treat it as the vertex position.
+		const GLuint ATTRIB_POSITION = 0;
+		const GLuint ATTRIB_COLOR = 1;
+		const GLuint ATTRIB_BASIS = 2;
+		const GLuint ATTRIB_OFFSET = 3;
+		const GLuint ATTRIB_TINT = 4;
+
+		const char *VERTEX_SHADER =
+			"#version 120\n"
+			"attribute vec2 position;\n"
+			"attribute vec4 color;\n"
+			"attribute vec4 basis;\n"
+			"attribute vec3 offset;\n"
+			"attribute vec4 tint;\n"
+			"varying vec4 vertexColor;\n"
+			"void main() {\n"
+			"	vec2 world = vec2(basis.x * position.x + basis.z * position.y,\n"
+			"		basis.y * position.x + basis.w * position.y) + offset.xy;\n"
+			"	gl_Position = gl_ModelViewProjectionMatrix * vec4(world, offset.z, 1.0);\n"
+			"	vertexColor = color * tint;\n"
+			"}\n";
+
+		const char *FRAGMENT_SHADER =
+			"#version 120\n"
+			"varying vec4 vertexColor;\n"
+			"void main() {\n"
+			"	gl_FragColor = vertexColor;\n"
+			"}\n";
+
+		GLuint compileShader(GLenum type, const char *source){
+			GLuint shader = GlExtensions::CreateShader(type);
+			GlExtensions::ShaderSource(shader, 1, &source, NULL);
+			GlExtensions::CompileShader(shader);
+			GLint ok = 0;
+			GlExtensions::GetShaderiv(shader, GL_COMPILE_STATUS, &ok);
+			if (!ok) {
+				GlExtensions::DeleteShader(shader);
+				return 0;
+			}
+			return shader;
+		}
+	}
+
+	InstanceRenderer::InstanceRenderer()
+	{
+		program = 0;
+		shapeBuffer = 0;
+		instanceBuffer = 0;
+		instanceCapacity = 0;
+		failed = false;
+	}
+
+	InstanceRenderer::~InstanceRenderer()
+	{
+		// The context may already be gone at exit; only free what we made.
+		if (program != 0 || shapeBuffer != 0 || instanceBuffer != 0) Release();
+	}
+
+	GLuint InstanceRenderer::buildProgram(){
+		GLuint vertexShader = compileShader(GL_VERTEX_SHADER, VERTEX_SHADER);
+		GLuint fragmentShader = compileShader(GL_FRAGMENT_SHADER, FRAGMENT_SHADER);
+		if (vertexShader == 0 || fragmentShader == 0) {
+			if (vertexShader != 0) GlExtensions::DeleteShader(vertexShader);
+			if (fragmentShader != 0) GlExtensions::DeleteShader(fragmentShader);
+			return 0;
+		}
+
+		GLuint result = GlExtensions::CreateProgram();
+		GlExtensions::AttachShader(result, vertexShader);
+		GlExtensions::AttachShader(result, fragmentShader);
+		GlExtensions::BindAttribLocation(result, ATTRIB_POSITION, "position");
+		GlExtensions::BindAttribLocation(result, ATTRIB_COLOR, "color");
+		GlExtensions::BindAttribLocation(result, ATTRIB_BASIS, "basis");
+		GlExtensions::BindAttribLocation(result, ATTRIB_OFFSET, "offset");
+		GlExtensions::BindAttribLocation(result, ATTRIB_TINT, "tint");
+		GlExtensions::LinkProgram(result);
+		GlExtensions::DeleteShader(vertexShader);	// Freed with the program
+		GlExtensions::DeleteShader(fragmentShader);
+
+		GLint ok = 0;
+		GlExtensions::GetProgramiv(result, GL_LINK_STATUS, &ok);
+		if (!ok) {
+			GlExtensions::DeleteProgram(result);
+			return 0;
+		}
+		return result;
+	}
+
+	bool InstanceRenderer::Create(){
+		if (program != 0) return true;
+		if (failed) return false;
+		failed = true;
+		if (!GlExtensions::HasInstancing()) return false;
+
+		program = buildProgram();
+		if (program == 0) return false;
+
+		// Every shape goes into one static buffer, uploaded once.
+		std::vector<ShapeVertex> data;
+		auto addVertex = [&data](float x, float y, float r, float g, float b) {
+			ShapeVertex v = { x, y, { (unsigned char)(r * 255.0f + 0.5f), (unsigned char)(g * 255.0f + 0.5f), (unsigned char)(b * 255.0f + 0.5f), 255 } };
+			data.push_back(v);
+		};
+		GLint first = 0;
+		shapes[SHAPE_SQUARE].mode = GL_TRIANGLE_FAN;	// Same colors as Element::Draw()
+		shapes[SHAPE_SQUARE].first = first;
+		shapes[SHAPE_SQUARE].count = 4;
+		addVertex(-0.3f, -0.3f, 1.0f, 0.0f, 0.0f);
+		addVertex(-0.3f, 0.3f, 1.0f, 0.0f, 0.0f);
+		addVertex(0.3f, 0.3f, 0.0f, 0.0f, 1.0f);
+		addVertex(0.3f, -0.3f, 0.0f, 0.0f, 1.0f);
+		first += 4;
+		for (int lod = 0; lod < ShapeCache::CIRCLE_LOD_COUNT; lod++) {
+			const ShapeMesh &mesh = ShapeCache::Circle(lod);
+			ShapeRange &range = shapes[CircleShape(lod)];
+			range.mode = GL_TRIANGLE_FAN;
+			range.first = first;
+			range.count = mesh.count;
+			for (int i = 0; i < mesh.count; i++) addVertex(mesh.xy[2 * i], mesh.xy[2 * i + 1], 1.0f, 1.0f, 1.0f);
+			first += mesh.count;
+		}
+
+		GlExtensions::GenBuffers(1, &shapeBuffer);
+		GlExtensions::BindBuffer(GL_ARRAY_BUFFER, shapeBuffer);
+		GlExtensions::BufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(data.size() * sizeof(ShapeVertex)), &data[0], GL_STATIC_DRAW);
+		GlExtensions::GenBuffers(1, &instanceBuffer);
+		GlExtensions::BindBuffer(GL_ARRAY_BUFFER, 0);
+		failed = false;
+		return true;
+	}
+
+	void InstanceRenderer::Release(){
+		if (GlExtensions::DeleteBuffers != NULL) {
+			if (shapeBuffer != 0) GlExtensions::DeleteBuffers(1, &shapeBuffer);
+			if (instanceBuffer != 0) GlExtensions::DeleteBuffers(1, &instanceBuffer);
+		}
+		if (program != 0 && GlExtensions::DeleteProgram != NULL) GlExtensions::DeleteProgram(program);
+		program = 0;
+		shapeBuffer = 0;
+		instanceBuffer = 0;
+		instanceCapacity = 0;
+	}
+
+	void InstanceRenderer::Upload(const Instance *instances, size_t count){
+		const size_t bytes = count * sizeof(Instance);
+		GlExtensions::BindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+		if (bytes > instanceCapacity) {
+			while (instanceCapacity < bytes) instanceCapacity = instanceCapacity == 0 ? 64 * 1024 : instanceCapacity * 2;
+		}
+		// Orphan the old storage: the driver hands out fresh memory while the
+		// previous frame's draws still read the old one.
+		GlExtensions::BufferData(GL_ARRAY_BUFFER, (GLsizeiptr)instanceCapacity, NULL, GL_STREAM_DRAW);
+		if (bytes > 0) GlExtensions::BufferSubData(GL_ARRAY_BUFFER, 0, (GLsizeiptr)bytes, instances);
+		GlExtensions::BindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+
+	void InstanceRenderer::Begin(){
+		GlExtensions::UseProgram(program);
+		GlExtensions::BindBuffer(GL_ARRAY_BUFFER, shapeBuffer);
+		GlExtensions::EnableVertexAttribArray(ATTRIB_POSITION);
+		GlExtensions::EnableVertexAttribArray(ATTRIB_COLOR);
+		GlExtensions::VertexAttribPointer(ATTRIB_POSITION, 2, GL_FLOAT, GL_FALSE, sizeof(ShapeVertex), (const void *)offsetof(ShapeVertex, x));
+		GlExtensions::VertexAttribPointer(ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(ShapeVertex), (const void *)offsetof(ShapeVertex, color));
+
+		GlExtensions::BindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+		GlExtensions::EnableVertexAttribArray(ATTRIB_BASIS);
+		GlExtensions::EnableVertexAttribArray(ATTRIB_OFFSET);
+		GlExtensions::EnableVertexAttribArray(ATTRIB_TINT);
+		GlExtensions::VertexAttribDivisor(ATTRIB_BASIS, 1);
+		GlExtensions::VertexAttribDivisor(ATTRIB_OFFSET, 1);
+		GlExtensions::VertexAttribDivisor(ATTRIB_TINT, 1);
+	}
+
+	void InstanceRenderer::Draw(int shape, size_t first, size_t count){
+		// No base instance before GL 4.2, so point the instanced attributes at the run.
+		const size_t base = first * sizeof(Instance);
+		GlExtensions::VertexAttribPointer(ATTRIB_BASIS, 4, GL_FLOAT, GL_FALSE, sizeof(Instance), (const void *)(base + offsetof(Instance, basis)));
+		GlExtensions::VertexAttribPointer(ATTRIB_OFFSET, 3, GL_FLOAT, GL_FALSE, sizeof(Instance), (const void *)(base + offsetof(Instance, offset)));
+		GlExtensions::VertexAttribPointer(ATTRIB_TINT, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Instance), (const void *)(base + offsetof(Instance, color)));
+		const ShapeRange &range = shapes[shape];
+		GlExtensions::DrawArraysInstanced(range.mode, range.first, range.count, (GLsizei)count);
+	}
+
+	void InstanceRenderer::End(){
+		GlExtensions::VertexAttribDivisor(ATTRIB_BASIS, 0);
+		GlExtensions::VertexAttribDivisor(ATTRIB_OFFSET, 0);
+		GlExtensions::VertexAttribDivisor(ATTRIB_TINT, 0);
+		GlExtensions::DisableVertexAttribArray(ATTRIB_TINT);
+		GlExtensions::DisableVertexAttribArray(ATTRIB_OFFSET);
+		GlExtensions::DisableVertexAttribArray(ATTRIB_BASIS);
+		GlExtensions::DisableVertexAttribArray(ATTRIB_COLOR);
+		GlExtensions::DisableVertexAttribArray(ATTRIB_POSITION);
+		GlExtensions::BindBuffer(GL_ARRAY_BUFFER, 0);
+		GlExtensions::UseProgram(0);
+	}
+}
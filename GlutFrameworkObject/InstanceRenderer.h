@@ -0,0 +1,120 @@
+///////////////////////////////////////////////////////////////////////////////
+/// GlFrameworkBasic is free software : you can redistribute it and or modify
+/// it under the terms of the GNU General Public License as published by
+/// the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// GlFrameworkBasic is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with GlFrameworkBasic. If not, see <http://www.gnu.org/licenses/>.
+///
+/// Author: Evan Edstrom
+/// Date: 11/17/2013
+/// Website: http://evanedstrom.com/glstart
+/// Email: contact@evanedstrom.com
+///
+///////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+#include <GL\glut.h>
+#include <cstddef>
+
+#include "ShapeCache.h"
+
+namespace glFrameworkBasic {
+	/**
+	* InstanceRenderer draws many copies of the framework's built-in shapes
+	* with one instanced draw call per run of the same shape. Each shape's
+	* vertices are uploaded once into a static vertex buffer; per instance
+	* data (2D basis, offset, depth and a color that tints the shape's vertex
+	* colors) is streamed each frame into a second buffer that is orphaned
+	* before the upload, so the driver never stalls on last frame's copy.
+	* A GLSL 1.20 vertex shader applies the instance transform on the GPU.
+	* Needs buffer objects, shaders and instanced arrays, see
+	* GlExtensions::HasInstancing(); RenderBatch uses it when available and
+	* falls back to its CPU transformed vertex arrays otherwise.
+	*/
+	class InstanceRenderer
+	{
+	public:
+		/// <summary>Built-in shapes. Circles take one id per level of detail, see CircleShape().</summary>
+		enum Shape {
+			SHAPE_SQUARE = 0,	// Element's sample square, red left and blue right edge
+			SHAPE_CIRCLE = 1,	// White circle of diameter 1, coarsest level of detail
+			SHAPE_COUNT = SHAPE_CIRCLE + ShapeCache::CIRCLE_LOD_COUNT
+		};
+
+		/// <summary>Shape id of ShapeCache::Circle(lod).</summary>
+		static int CircleShape(int lod) { return SHAPE_CIRCLE + lod; }
+
+		/// <summary>Per instance data, laid out as the shader's instanced attributes.</summary>
+		struct Instance {
+			float basis[4];				// Transform a, b, c, d
+			float offset[3];			// Transform tx, ty, z
+			unsigned char color[4];		// Multiplies the shape's vertex colors
+		};
+
+		InstanceRenderer();
+
+		/// <summary>Destructor. Frees the GL objects if they still exist.</summary>
+		~InstanceRenderer();
+
+		/// <summary>
+		/// Uploads the shapes and builds the shader with the current context.
+		/// Returns false, and keeps failing without retrying, when the context
+		/// lacks instancing support or the shader does not compile.
+		/// </summary>
+		bool Create();
+
+		/// <summary>True after a successful Create().</summary>
+		bool IsCreated() const { return program != 0; }
+
+		/// <summary>Frees the buffers and the shader. Needs the owning context current.</summary>
+		void Release();
+
+		/// <summary>Streams this frame's instances into the instance buffer.</summary>
+		void Upload(const Instance *instances, size_t count);
+
+		/// <summary>Binds the shader and the shape buffer for Draw() calls.</summary>
+		void Begin();
+
+		/// <summary>Draws count uploaded instances, starting at first, of one shape.</summary>
+		void Draw(int shape, size_t first, size_t count);
+
+		/// <summary>Ends Begin(): unbinds the shader and buffers.</summary>
+		void End();
+
+	private:
+		/// <summary>Vertex layout of the shape buffer.</summary>
+		struct ShapeVertex {
+			float x, y;
+			unsigned char color[4];
+		};
+
+		/// <summary>Range of a shape in the shape buffer.</summary>
+		struct ShapeRange {
+			GLenum mode;
+			GLint first;
+			GLsizei count;
+		};
+
+		GLuint program;
+		GLuint shapeBuffer;
+		GLuint instanceBuffer;
+		size_t instanceCapacity;	// Bytes allocated in instanceBuffer
+		ShapeRange shapes[SHAPE_COUNT];
+		bool failed;				// Create() failed, do not try again
+
+		/// <summary>Compiles and links the shader. Returns the program or 0.</summary>
+		static GLuint buildProgram();
+
+		// Copy is not allowed, the GL objects are owned.
+		InstanceRenderer(const InstanceRenderer &);
+		InstanceRenderer &operator=(const InstanceRenderer &);
+	};
+}
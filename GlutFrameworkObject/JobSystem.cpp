@@ -0,0 +1,180 @@
+///////////////////////////////////////////////////////////////////////////////
+/// GlFrameworkBasic is free software : you can redistribute it and or modify
+/// it under the terms of the GNU General Public License as published by
+/// the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// GlFrameworkBasic is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with GlFrameworkBasic. If not, see <http://www.gnu.org/licenses/>.
+///
+/// Author: Evan Edstrom
+/// Date: 11/17/2013
+/// Website: http://evanedstrom.com/glstart
+/// Email: contact@evanedstrom.com
+///
+///////////////////////////////////////////////////////////////////////////////
+
+#include "JobSystem.h"
+#include "Platform.h"
+#include <utility>
+
+namespace glFrameworkBasic {
+	namespace {
+		// Which pool and queue the current thread works for, if any.
+		GLFRAMEWORK_THREAD_LOCAL const JobSystem *currentSystem = NULL;
+		GLFRAMEWORK_THREAD_LOCAL int currentIndex = -1;
+	}
+
+	JobSystem::JobSystem(int workerCount)
+	{
+		if (workerCount < 0) {
+			workerCount = (int)std::thread::hardware_concurrency() - 1;
+			if (workerCount < 0) workerCount = 0;
+		}
+		pending = 0;
+		queued = 0;
+		quit = false;
+		nextQueue = 0;
+
+		// One queue per worker plus one shared by every other thread.
+		for (int i = 0; i <= workerCount; i++) {
+			Queue *queue = new Queue();
+			queue->ring.resize(64);
+			queue->head = 0;
+			queue->count = 0;
+			queues.push_back(queue);
+		}
+		for (int i = 0; i < workerCount; i++)
+			workers.push_back(std::thread(&JobSystem::workerLoop, this, i));
+	}
+
+	JobSystem::~JobSystem()
+	{
+		Wait();
+		{
+			std::lock_guard<std::mutex> guard(sleepLock);
+			quit = true;
+		}
+		wake.notify_all();
+		for (size_t i = 0; i < workers.size(); i++) workers[i].join();
+		for (size_t i = 0; i < queues.size(); i++) delete queues[i];
+	}
+
+	void JobSystem::Schedule(const Job &job){
+		Task task = { NULL, NULL, job };
+		push(task);
+	}
+
+	void JobSystem::Schedule(JobProc proc, void *context){
+		Task task = { proc, context, Job() };
+		push(task);
+	}
+
+	void JobSystem::push(Task &task){
+		int index = currentQueue();
+		if (index < 0) {
+			// Outside threads spread their jobs so workers start without stealing.
+			index = queues.size() > 1 ? (int)(nextQueue++ % (queues.size() - 1)) : 0;
+		}
+		pending++;
+		{
+			Queue &queue = *queues[index];
+			std::lock_guard<std::mutex> guard(queue.lock);
+			if (queue.count == queue.ring.size()) {
+				// Full: unroll into a ring twice the size, oldest first.
+				std::vector<Task> larger(queue.ring.size() * 2);
+				for (size_t i = 0; i < queue.count; i++)
+					larger[i] = std::move(queue.ring[(queue.head + i) & (queue.ring.size() - 1)]);
+				queue.ring.swap(larger);
+				queue.head = 0;
+			}
+			queue.ring[(queue.head + queue.count) & (queue.ring.size() - 1)] = std::move(task);
+			queue.count++;
+		}
+		queued++;
+		{
+			// Taking the lock orders this with a worker about to sleep, so
+			// the notify cannot fall between its check and its wait.
+			std::lock_guard<std::mutex> guard(sleepLock);
+		}
+		wake.notify_one();
+	}
+
+	void JobSystem::Wait(){
+		const int index = currentQueue() < 0 ? (int)queues.size() - 1 : currentQueue();
+		Task task;
+		while (pending > 0) {
+			if (findJob(index, task)) runJob(task);
+			else std::this_thread::yield();
+		}
+	}
+
+	void JobSystem::WaitFor(const std::atomic<size_t> &counter){
+		const int index = currentQueue() < 0 ? (int)queues.size() - 1 : currentQueue();
+		Task task;
+		while (counter > 0) {
+			if (findJob(index, task)) runJob(task);
+			else std::this_thread::yield();
+		}
+	}
+
+	void JobSystem::workerLoop(int index){
+		currentSystem = this;
+		currentIndex = index;
+		Task task;
+		while (!quit) {
+			if (findJob(index, task)) {
+				runJob(task);
+				continue;
+			}
+			std::unique_lock<std::mutex> guard(sleepLock);
+			wake.wait(guard, [this]() { return quit || queued > 0; });
+		}
+	}
+
+	bool JobSystem::findJob(int index, Task &task){
+		// Own queue first, newest job (still warm in cache).
+		{
+			Queue &own = *queues[index];
+			std::lock_guard<std::mutex> guard(own.lock);
+			if (own.count > 0) {
+				own.count--;
+				task = std::move(own.ring[(own.head + own.count) & (own.ring.size() - 1)]);
+				queued--;
+				return true;
+			}
+		}
+		// Then steal the oldest job from someone else.
+		const size_t n = queues.size();
+		for (size_t i = 1; i < n; i++) {
+			Queue &victim = *queues[(index + i) % n];
+			std::lock_guard<std::mutex> guard(victim.lock);
+			if (victim.count > 0) {
+				task = std::move(victim.ring[victim.head]);
+				victim.head = (victim.head + 1) & (victim.ring.size() - 1);
+				victim.count--;
+				queued--;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void JobSystem::runJob(Task &task){
+		if (task.proc != NULL) task.proc(task.context);
+		else {
+			task.job();
+			task.job = Job();	// Release captures before signalling
+		}
+		pending--;
+	}
+
+	int JobSystem::currentQueue() const {
+		return currentSystem == this ? currentIndex : -1;
+	}
+}
@@ -0,0 +1,177 @@
+///////////////////////////////////////////////////////////////////////////////
+/// GlFrameworkBasic is free software : you can redistribute it and or modify
+/// it under the terms of the GNU General Public License as published by
+/// the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// GlFrameworkBasic is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with GlFrameworkBasic. If not, see <http://www.gnu.org/licenses/>.
+///
+/// Author: Evan Edstrom
+/// Date: 11/17/2013
+/// Website: http://evanedstrom.com/glstart
+/// Email: contact@evanedstrom.com
+///
+///////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace glFrameworkBasic {
+	/**
+	* JobSystem is a work-stealing thread pool. Every worker owns a deque:
+	* it pops its own jobs from the back and, when empty, steals from the
+	* front of another worker's deque, so uneven chunks still balance out.
+	* The thread that calls Wait() or ParallelFor() also runs jobs instead of
+	* blocking, so a pool with zero workers runs everything inline.
+	* A job is either a std::function or a function pointer with a context
+	* pointer. The latter and ParallelFor() never touch the heap once the
+	* deques have grown to their working size, so the engine can schedule
+	* them every frame.
+	*/
+	class JobSystem
+	{
+	public:
+		typedef std::function<void()> Job;
+		typedef void (*JobProc)(void *context);
+
+		/// <summary>
+		/// Starts workerCount threads. Default (-1) uses one less than the
+		/// number of hardware threads, leaving a core for the GLUT thread.
+		/// </summary>
+		explicit JobSystem(int workerCount = -1);
+
+		/// <summary>Destructor. Finishes queued jobs and joins all workers.</summary>
+		~JobSystem();
+
+		/// <summary>Queues a job. Safe to call from any thread, including jobs.</summary>
+		void Schedule(const Job &job);
+
+		/// <summary>
+		/// Queues proc(context). Does not allocate; context must stay valid
+		/// until the job has run.
+		/// </summary>
+		void Schedule(JobProc proc, void *context);
+
+		/// <summary>Runs queued jobs on the calling thread until all jobs are done.</summary>
+		void Wait();
+
+		/// <summary>
+		/// Runs queued jobs on the calling thread until counter reaches zero.
+		/// Lets a thread wait for its own jobs without waiting for everyone's.
+		/// </summary>
+		void WaitFor(const std::atomic<size_t> &counter);
+
+		/// <summary>
+		/// Splits [0, count) into chunks of at most grainSize and calls
+		/// body(begin, end) for each chunk in parallel. Returns when all are done.
+		/// Body is called in place, without being wrapped in a std::function.
+		/// </summary>
+		template <class Body>
+		void ParallelFor(size_t count, size_t grainSize, const Body &body);
+
+		/// <summary>Number of worker threads (not counting callers of Wait).</summary>
+		int WorkerCount() const { return (int)workers.size(); }
+
+	private:
+		/// <summary>A queued job: proc(context) when proc is set, else job().</summary>
+		struct Task {
+			JobProc proc;
+			void *context;
+			Job job;
+		};
+
+		/// <summary>
+		/// Per-worker deque, a ring that only grows. Index workers.size() is
+		/// used by outside threads.
+		/// </summary>
+		struct Queue {
+			std::mutex lock;
+			std::vector<Task> ring;		// Size is a power of two
+			size_t head;				// Oldest task
+			size_t count;
+		};
+
+		/// <summary>Shared state of one ParallelFor(); each job claims the next chunk.</summary>
+		template <class Body>
+		struct ForLoop {
+			const Body *body;
+			size_t count, grainSize;
+			std::atomic<size_t> next;		// Next chunk to claim
+			std::atomic<size_t> remaining;	// Chunks not finished
+
+			static void runChunk(void *context);
+		};
+
+		std::vector<std::thread> workers;
+		std::vector<Queue *> queues;
+		std::atomic<int> pending;		// Jobs scheduled but not finished
+		std::atomic<int> queued;		// Jobs scheduled but not yet taken, idle workers sleep while 0
+		std::atomic<bool> quit;
+		std::atomic<unsigned int> nextQueue;	// Round robin target for outside threads
+		std::mutex sleepLock;
+		std::condition_variable wake;
+
+		void workerLoop(int index);
+
+		/// <summary>Adds task to the calling thread's queue and wakes a worker.</summary>
+		void push(Task &task);
+
+		/// <summary>Pops from queue index or steals from the others. Returns false if all empty.</summary>
+		bool findJob(int index, Task &task);
+
+		/// <summary>Runs one job and signals completion.</summary>
+		void runJob(Task &task);
+
+		/// <summary>Queue owned by the calling thread, or the shared one.</summary>
+		int currentQueue() const;
+
+		// Copy is not allowed, threads are owned.
+		JobSystem(const JobSystem &);
+		JobSystem &operator=(const JobSystem &);
+	};
+
+	template <class Body>
+	void JobSystem::ParallelFor(size_t count, size_t grainSize, const Body &body){
+		if (count == 0) return;
+		if (grainSize == 0) grainSize = 1;
+		if (workers.empty() || count <= grainSize) {
+			body(0, count);		// Nothing to gain from splitting.
+			return;
+		}
+
+		// The loop lives on this stack frame until WaitFor() returns, so the
+		// jobs only carry a pointer to it.
+		const size_t chunks = (count + grainSize - 1) / grainSize;
+		ForLoop<Body> loop;
+		loop.body = &body;
+		loop.count = count;
+		loop.grainSize = grainSize;
+		loop.next = 0;
+		loop.remaining = chunks;
+		for (size_t i = 0; i < chunks; i++) Schedule(&ForLoop<Body>::runChunk, &loop);
+
+		// Help out until every chunk of this loop is finished.
+		WaitFor(loop.remaining);
+	}
+
+	template <class Body>
+	void JobSystem::ForLoop<Body>::runChunk(void *context){
+		ForLoop &loop = *(ForLoop *)context;
+		const size_t begin = loop.next++ * loop.grainSize;
+		const size_t end = begin + loop.grainSize < loop.count ? begin + loop.grainSize : loop.count;
+		(*loop.body)(begin, end);
+		loop.remaining--;	// Last touch, the loop may be gone after this
+	}
+}
@@ -31,30 +31,33 @@ namespace glFrameworkBasic {
 		// Add items to vector for test.
 		OscillateEngine()
 		{
+			SetBatching(true);	// Circle and Element both support Submit()
+			SetInstancing(true);	// GPU instances where the driver allows, else the CPU batch
+			SetStaticLayer(true);	// Box and squares are drawn once, then cached
+
 			// Make Circle
-			Circle *oscillateCircle = new Circle();
+			Circle *oscillateCircle = Get<Circle>(Spawn<Circle>());
 			oscillateCircle->SetVelocity(2, 0.5);
 			oscillateCircle->SetScale(20);
-			drawItems.push_back(oscillateCircle);
 
 			// Make Top Square
-			Element *square = new Element();
+			Element *square = Get(Spawn<Element>());
 			square->SetScale(10);
 			square->SetPosition(0, 40);
-			drawItems.push_back(square);
+			square->SetStatic(true);
 
 			// Make Bottom Square
-			Element *square2 = new Element();
+			Element *square2 = Get(Spawn<Element>());
 			square2->SetScale(10);
 			square2->SetPosition(0, -40);
 			square2->SetAngle(180);
-			drawItems.push_back(square2);
+			square2->SetStatic(true);
 		}
 
 		~OscillateEngine() {}
 
-		// Draw bounding box before every frame.
-		void preDisplayLoop()
+		// Draw bounding box into the static layer.
+		void drawStaticLayer()
 		{
 			glPushMatrix();						// Save model-view matrix setting
 
@@ -0,0 +1,253 @@
+///////////////////////////////////////////////////////////////////////////////
+/// GlFrameworkBasic is free software : you can redistribute it and or modify
+/// it under the terms of the GNU General Public License as published by
+/// the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// GlFrameworkBasic is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with GlFrameworkBasic. If not, see <http://www.gnu.org/licenses/>.
+///
+/// Author: Evan Edstrom
+/// Date: 11/17/2013
+/// Website: http://evanedstrom.com/glstart
+/// Email: contact@evanedstrom.com
+///
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include "ParticleSystem.h"
+#include "JobSystem.h"
+#include <cmath>
+#include <cstring>
+
+namespace glFrameworkBasic {
+	namespace {
+		// Particles per parallel chunk, a multiple of SIMD_WIDTH.
+		const size_t PARTICLE_GRAIN = 16384;
+
+		unsigned char toByte(float v){
+			if (v <= 0.0f) return 0;
+			if (v >= 1.0f) return 255;
+			return (unsigned char)(v * 255.0f + 0.5f);
+		}
+	}
+
+	ParticleEmitter::ParticleEmitter()
+	{
+		x = 0.0f; y = 0.0f;
+		rate = 100.0f;
+		lifeMin = 1.0f; lifeMax = 1.0f;
+		speedMin = 5.0f; speedMax = 10.0f;
+		direction = 90.0f; spread = 180.0f;
+		xAccel = 0.0f; yAccel = 0.0f;
+		for (int i = 0; i < 4; i++) {
+			startColor[i] = 1.0f;
+			endColor[i] = i < 3 ? 1.0f : 0.0f;
+		}
+		startSize = 1.0f; endSize = 1.0f;
+		active = true;
+	}
+
+	ParticleSystem::ParticleSystem()
+	{
+		count = 0;
+		maxParticles = 0;
+		random = 2463534242u;
+		preparedCount = 0;
+	}
+
+	unsigned int ParticleSystem::AddEmitter(const ParticleEmitter &emitter){
+		emitters.push_back(emitter);
+		emitCarry.push_back(0.0f);
+		return (unsigned int)(emitters.size() - 1);
+	}
+
+	void ParticleSystem::SetMaxParticles(size_t max){
+		maxParticles = max;
+	}
+
+	void ParticleSystem::Reserve(size_t n){
+		grow(n);
+	}
+
+	void ParticleSystem::SetSeed(unsigned int seed){
+		random = seed != 0 ? seed : 2463534242u;	// xorshift never leaves 0
+	}
+
+	void ParticleSystem::Clear(){
+		// Zero the used lanes so the padding invariant of the arrays holds.
+		const size_t used = SimdRoundUp(count) * sizeof(float);
+		if (used > 0) {
+			AlignedFloatArray *arrays[] = { &xPos, &yPos, &xVel, &yVel, &xAccel, &yAccel, &age, &ageRate };
+			for (size_t a = 0; a < sizeof(arrays) / sizeof(arrays[0]); a++)
+				memset(arrays[a]->Data(), 0, used);
+		}
+		count = 0;
+		source.clear();
+		preparedCount = 0;
+	}
+
+	float ParticleSystem::nextRandom(float low, float high){
+		random ^= random << 13;
+		random ^= random >> 17;
+		random ^= random << 5;
+		return low + (high - low) * (float)((random >> 8) * (1.0 / 16777216.0));
+	}
+
+	void ParticleSystem::grow(size_t n){
+		const size_t lanes = SimdRoundUp(n);
+		if (lanes <= xPos.Capacity()) return;
+		xPos.Reserve(lanes); yPos.Reserve(lanes);
+		xVel.Reserve(lanes); yVel.Reserve(lanes);
+		xAccel.Reserve(lanes); yAccel.Reserve(lanes);
+		age.Reserve(lanes); ageRate.Reserve(lanes);
+		source.reserve(lanes);
+	}
+
+	void ParticleSystem::Emit(unsigned int emitterIndex, size_t n){
+		if (emitterIndex >= emitters.size()) return;
+		if (maxParticles > 0 && count + n > maxParticles)
+			n = count < maxParticles ? maxParticles - count : 0;
+		if (n == 0) return;
+		grow(count + n);
+
+		const ParticleEmitter &e = emitters[emitterIndex];
+		const float toRadians = 3.14159265f / 180.0f;
+		for (size_t k = 0; k < n; k++) {
+			const size_t i = count++;
+			const float angle = (e.direction + nextRandom(-e.spread, e.spread)) * toRadians;
+			const float speed = nextRandom(e.speedMin, e.speedMax);
+			const float life = nextRandom(e.lifeMin, e.lifeMax);
+			xPos[i] = e.x; yPos[i] = e.y;
+			xVel[i] = speed * cos(angle); yVel[i] = speed * sin(angle);
+			xAccel[i] = e.xAccel; yAccel[i] = e.yAccel;
+			age[i] = 0.0f;
+			ageRate[i] = life > 0.0f ? 1.0f / life : 1.0e9f;	// Zero life dies next update
+			source.push_back(emitterIndex);
+		}
+	}
+
+	bool ParticleSystem::IsAnimating() const {
+		if (count > 0) return true;
+		for (size_t e = 0; e < emitters.size(); e++) {
+			if (emitters[e].active && emitters[e].rate > 0.0f) return true;
+		}
+		return false;
+	}
+
+	void ParticleSystem::Update(float dt, JobSystem *jobs){
+		// Whole SIMD lanes; the padding past count stays zero so it is harmless.
+		const size_t lanes = SimdRoundUp(count);
+		ParticleSystem &self = *this;
+		const auto integrate = [&self, dt](size_t begin, size_t end) {
+			const size_t n = end - begin;
+			SimdMultiplyAdd(self.xVel.Data() + begin, self.xAccel.Data() + begin, dt, n);
+			SimdMultiplyAdd(self.yVel.Data() + begin, self.yAccel.Data() + begin, dt, n);
+			SimdMultiplyAdd(self.xPos.Data() + begin, self.xVel.Data() + begin, dt, n);
+			SimdMultiplyAdd(self.yPos.Data() + begin, self.yVel.Data() + begin, dt, n);
+			SimdMultiplyAdd(self.age.Data() + begin, self.ageRate.Data() + begin, dt, n);
+		};
+		if (jobs != NULL) jobs->ParallelFor(lanes, PARTICLE_GRAIN, integrate);
+		else if (lanes > 0) integrate(0, lanes);
+
+		compact();
+
+		for (size_t e = 0; e < emitters.size(); e++) {
+			if (!emitters[e].active || emitters[e].rate <= 0.0f) continue;
+			emitCarry[e] += emitters[e].rate * dt;
+			const size_t n = (size_t)emitCarry[e];
+			emitCarry[e] -= (float)n;
+			Emit((unsigned int)e, n);
+		}
+	}
+
+	void ParticleSystem::compact(){
+		const size_t before = count;
+		size_t i = 0;
+		while (i < count) {
+			if (age[i] < 1.0f) {
+				i++;
+				continue;
+			}
+			// Move the last particle into the hole; it is checked next.
+			const size_t last = --count;
+			xPos[i] = xPos[last]; yPos[i] = yPos[last];
+			xVel[i] = xVel[last]; yVel[i] = yVel[last];
+			xAccel[i] = xAccel[last]; yAccel[i] = yAccel[last];
+			age[i] = age[last]; ageRate[i] = ageRate[last];
+			source[i] = source[last];
+		}
+		if (count == before) return;
+
+		source.resize(count);
+		const size_t tail = SimdRoundUp(before) - count;
+		AlignedFloatArray *arrays[] = { &xPos, &yPos, &xVel, &yVel, &xAccel, &yAccel, &age, &ageRate };
+		for (size_t a = 0; a < sizeof(arrays) / sizeof(arrays[0]); a++)
+			memset(arrays[a]->Data() + count, 0, tail * sizeof(float));
+	}
+
+	void ParticleSystem::buildTables(){
+		colorTable.resize(emitters.size() * LIFE_STEPS * 4);
+		sizeTable.resize(emitters.size() * LIFE_STEPS);
+		for (size_t e = 0; e < emitters.size(); e++) {
+			const ParticleEmitter &emitter = emitters[e];
+			for (int step = 0; step < LIFE_STEPS; step++) {
+				const float t = step / (float)(LIFE_STEPS - 1);
+				unsigned char *rgba = &colorTable[(e * LIFE_STEPS + step) * 4];
+				for (int c = 0; c < 4; c++)
+					rgba[c] = toByte(emitter.startColor[c] + (emitter.endColor[c] - emitter.startColor[c]) * t);
+				sizeTable[e * LIFE_STEPS + step] = 0.5f * (emitter.startSize + (emitter.endSize - emitter.startSize) * t);
+			}
+		}
+	}
+
+	void ParticleSystem::Prepare(float offset, JobSystem *jobs){
+		buildTables();	// Emitters may have changed since the last frame
+		preparedCount = count;
+		if (vertices.size() < count * 4) vertices.resize(count * 4);
+		ParticleSystem &self = *this;
+		const auto build = [&self, offset](size_t begin, size_t end) { self.prepareRange(begin, end, offset); };
+		if (jobs != NULL) jobs->ParallelFor(count, PARTICLE_GRAIN, build);
+		else if (count > 0) build(0, count);
+	}
+
+	void ParticleSystem::prepareRange(size_t begin, size_t end, float offset){
+		Vertex *v = &vertices[begin * 4];
+		const float lifeScale = (float)(LIFE_STEPS - 1);
+		for (size_t i = begin; i < end; i++, v += 4) {
+			const int step = age[i] < 1.0f ? (int)(age[i] * lifeScale) : LIFE_STEPS - 1;
+			const size_t entry = source[i] * LIFE_STEPS + step;
+			const float half = sizeTable[entry];
+			const unsigned char *rgba = &colorTable[entry * 4];
+			const float x = xPos[i] + xVel[i] * offset;
+			const float y = yPos[i] + yVel[i] * offset;
+
+			// Counter clockwise from bottom left, like RenderBatch::AddQuad.
+			v[0].x = x - half; v[0].y = y - half;
+			v[1].x = x + half; v[1].y = y - half;
+			v[2].x = x + half; v[2].y = y + half;
+			v[3].x = x - half; v[3].y = y + half;
+			for (int k = 0; k < 4; k++) memcpy(v[k].rgba, rgba, 4);
+		}
+	}
+
+	void ParticleSystem::Render(){
+		if (preparedCount == 0) return;
+
+		glEnable(GL_BLEND);
+		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		glEnableClientState(GL_VERTEX_ARRAY);
+		glEnableClientState(GL_COLOR_ARRAY);
+		glVertexPointer(2, GL_FLOAT, sizeof(Vertex), &vertices[0].x);
+		glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(Vertex), vertices[0].rgba);
+		glDrawArrays(GL_QUADS, 0, (GLsizei)(preparedCount * 4));
+		glDisableClientState(GL_COLOR_ARRAY);
+		glDisableClientState(GL_VERTEX_ARRAY);
+		glDisable(GL_BLEND);
+	}
+}
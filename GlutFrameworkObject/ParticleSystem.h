@@ -0,0 +1,166 @@
+///////////////////////////////////////////////////////////////////////////////
+/// GlFrameworkBasic is free software : you can redistribute it and or modify
+/// it under the terms of the GNU General Public License as published by
+/// the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// GlFrameworkBasic is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with GlFrameworkBasic. If not, see <http://www.gnu.org/licenses/>.
+///
+/// Author: Evan Edstrom
+/// Date: 11/17/2013
+/// Website: http://evanedstrom.com/glstart
+/// Email: contact@evanedstrom.com
+///
+///////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+#include <GL\glut.h>
+#include <vector>
+
+#include "Simd.h"
+
+namespace glFrameworkBasic {
+	class JobSystem;
+
+	/**
+	* Describes how an emitter makes particles and how they look over their
+	* life. Colors and sizes are blended linearly from start to end as a
+	* particle ages. Angles are in degrees, times in seconds.
+	*/
+	struct ParticleEmitter
+	{
+		float x, y;					// Spawn point in world units
+		float rate;					// Particles per second, 0 for Emit() bursts only
+		float lifeMin, lifeMax;		// Lifetime range
+		float speedMin, speedMax;	// Initial speed range
+		float direction, spread;	// Particles leave within direction +/- spread
+		float xAccel, yAccel;		// Constant acceleration, such as gravity
+		float startColor[4];		// RGBA at birth
+		float endColor[4];			// RGBA at death
+		float startSize, endSize;	// Edge of the square, world units
+		bool active;				// Emits at rate while true
+
+		/// <summary>Active emitter at the origin: 100 white particles per second fading out over one second.</summary>
+		ParticleEmitter();
+	};
+
+	/**
+	* ParticleSystem simulates and draws particles without an Element per
+	* particle. State lives in SIMD aligned structure-of-arrays buffers:
+	* Update() integrates acceleration, velocity and age with vectorized
+	* passes, then removes dead particles by moving the last live one into
+	* each hole. Prepare() expands every particle into a colored quad and
+	* Render() draws all of them with one glDrawArrays call.
+	* Prepare() and Render() are separate so Engine's pipelined mode can
+	* build the vertices before the next update starts.
+	*/
+	class ParticleSystem
+	{
+	public:
+		ParticleSystem();
+
+		/// <summary>Adds an emitter and returns its index. Emitters are never removed; deactivate them.</summary>
+		unsigned int AddEmitter(const ParticleEmitter &emitter);
+
+		/// <summary>Emitter by index, to move it or change its settings.</summary>
+		ParticleEmitter &Emitter(unsigned int index) { return emitters[index]; }
+
+		/// <summary>Number of emitters added.</summary>
+		size_t EmitterCount() const { return emitters.size(); }
+
+		/// <summary>Spawns count particles from an emitter right away.</summary>
+		void Emit(unsigned int emitter, size_t count);
+
+		/// <summary>
+		/// Most particles alive at once; emission beyond it is dropped.
+		/// 0 for no limit. Default 0.
+		/// </summary>
+		void SetMaxParticles(size_t max);
+
+		/// <summary>Allocates room for count particles up front.</summary>
+		void Reserve(size_t count);
+
+		/// <summary>Seeds the random numbers used for emission. Same seed, same particles.</summary>
+		void SetSeed(unsigned int seed);
+
+		/// <summary>Number of live particles.</summary>
+		size_t Size() const { return count; }
+
+		/// <summary>True while particles are alive or an active emitter has a rate.</summary>
+		bool IsAnimating() const;
+
+		/// <summary>Removes every particle. Emitters are kept.</summary>
+		void Clear();
+
+		/// <summary>
+		/// Advances every particle by dt seconds, removes the dead ones and
+		/// emits from the active emitters. Runs the vectorized passes in
+		/// parallel chunks when jobs is given.
+		/// </summary>
+		void Update(float dt, JobSystem *jobs = NULL);
+
+		/// <summary>
+		/// Builds the quads for the particles as they are now, moved along
+		/// their velocity by offset seconds (negative to draw between update
+		/// steps like Element interpolation).
+		/// </summary>
+		void Prepare(float offset = 0.0f, JobSystem *jobs = NULL);
+
+		/// <summary>Draws the quads built by the last Prepare() with one draw call, alpha blended.</summary>
+		void Render();
+
+		// Component arrays, valid for indices below Size().
+		AlignedFloatArray xPos, yPos;
+		AlignedFloatArray xVel, yVel;
+		AlignedFloatArray xAccel, yAccel;
+		AlignedFloatArray age;			// 0 at birth, 1 at death
+		AlignedFloatArray ageRate;		// 1 / lifetime
+		std::vector<unsigned int> source;	// Emitter of each particle
+
+	private:
+		std::vector<ParticleEmitter> emitters;
+		std::vector<float> emitCarry;	// Fractional particles owed per emitter
+		size_t count;
+		size_t maxParticles;
+		unsigned int random;			// xorshift32 state
+		/// <summary>2D vertex for glVertexPointer(2) / glColorPointer(4).</summary>
+		struct Vertex {
+			float x, y;
+			unsigned char rgba[4];
+		};
+		std::vector<Vertex> vertices;	// Four per particle, built by Prepare()
+		size_t preparedCount;
+
+		// Color and half size over life per emitter, LIFE_STEPS entries each,
+		// so Prepare() does no per particle blending.
+		static const int LIFE_STEPS = 256;
+		std::vector<unsigned char> colorTable;
+		std::vector<float> sizeTable;
+
+		/// <summary>Rebuilds colorTable and sizeTable from the emitters.</summary>
+		void buildTables();
+
+		/// <summary>Uniform random value in [low, high).</summary>
+		float nextRandom(float low, float high);
+
+		/// <summary>Grows every array to hold n particles.</summary>
+		void grow(size_t n);
+
+		/// <summary>Removes particles whose age reached 1.</summary>
+		void compact();
+
+		/// <summary>Quads for particles [begin, end).</summary>
+		void prepareRange(size_t begin, size_t end, float offset);
+
+		// Copy is not allowed, the buffers are owned.
+		ParticleSystem(const ParticleSystem &);
+		ParticleSystem &operator=(const ParticleSystem &);
+	};
+}
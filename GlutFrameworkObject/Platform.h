@@ -0,0 +1,44 @@
+///////////////////////////////////////////////////////////////////////////////
+/// GlFrameworkBasic is free software : you can redistribute it and or modify
+/// it under the terms of the GNU General Public License as published by
+/// the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// GlFrameworkBasic is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with GlFrameworkBasic. If not, see <http://www.gnu.org/licenses/>.
+///
+/// Author: Evan Edstrom
+/// Date: 11/17/2013
+/// Website: http://evanedstrom.com/glstart
+/// Email: contact@evanedstrom.com
+///
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// Thread local storage for plain data. Visual Studio 2013 has no thread_local.
+#if defined(_MSC_VER)
+#define GLFRAMEWORK_THREAD_LOCAL __declspec(thread)
+#else
+#define GLFRAMEWORK_THREAD_LOCAL __thread
+#endif
+
+// Address the current function returns to, used to name allocation call sites.
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define GLFRAMEWORK_RETURN_ADDRESS() _ReturnAddress()
+#else
+#define GLFRAMEWORK_RETURN_ADDRESS() __builtin_return_address(0)
+#endif
+
+// Non-throwing exception specification. Visual Studio 2013 has no noexcept.
+#if defined(_MSC_VER) && _MSC_VER < 1900
+#define GLFRAMEWORK_NOEXCEPT throw()
+#else
+#define GLFRAMEWORK_NOEXCEPT noexcept
+#endif
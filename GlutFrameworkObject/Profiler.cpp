@@ -0,0 +1,233 @@
+///////////////////////////////////////////////////////////////////////////////
+/// GlFrameworkBasic is free software : you can redistribute it and or modify
+/// it under the terms of the GNU General Public License as published by
+/// the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// GlFrameworkBasic is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with GlFrameworkBasic. If not, see <http://www.gnu.org/licenses/>.
+///
+/// Author: Evan Edstrom
+/// Date: 11/17/2013
+/// Website: http://evanedstrom.com/glstart
+/// Email: contact@evanedstrom.com
+///
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include "Profiler.h"
+#include "Clock.h"
+#include "Platform.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+
+namespace glFrameworkBasic {
+	namespace {
+		GLFRAMEWORK_THREAD_LOCAL Profiler *currentProfiler = NULL;
+		GLFRAMEWORK_THREAD_LOCAL unsigned int currentThreadId = 0;	// 0 until first sample
+		std::atomic<unsigned int> nextThreadId(1);
+
+		unsigned int threadId(){
+			if (currentThreadId == 0) currentThreadId = nextThreadId.fetch_add(1);
+			return currentThreadId;
+		}
+
+		void writeJsonString(std::ostream &out, const char *text){
+			out << '"';
+			for (const char *c = text; *c != '\0'; c++) {
+				if (*c == '"' || *c == '\\') out << '\\' << *c;
+				else if ((unsigned char)*c < 0x20) out << ' ';
+				else out << *c;
+			}
+			out << '"';
+		}
+	}
+
+	Profiler::Profiler(unsigned int capacityHint, unsigned int windowFrames)
+	{
+		capacity = 1;
+		while (capacity < capacityHint) capacity <<= 1;
+		window = windowFrames < 1 ? 1 : windowFrames;
+		enabled = false;
+		ring = NULL;
+		writeIndex.store(0);
+		frameStart = 0;
+	}
+
+	Profiler::~Profiler()
+	{
+		if (currentProfiler == this) currentProfiler = NULL;
+		delete[] ring;
+	}
+
+	void Profiler::SetEnabled(bool doEnable){
+		if (doEnable && ring == NULL) {
+			ring = new Sample[capacity];
+			for (unsigned int i = 0; i < capacity; i++) ring[i].sequence.store(0);
+		}
+		enabled = doEnable;
+	}
+
+	void Profiler::Record(const char *name, long long startTicks, long long endTicks){
+		if (!enabled) return;
+		const unsigned long long index = writeIndex.fetch_add(1, std::memory_order_relaxed);
+		Sample &sample = ring[index & (capacity - 1)];
+		sample.sequence.store(0, std::memory_order_relaxed);	// Unpublish while rewriting
+		sample.name = name;
+		sample.start = startTicks;
+		sample.end = endTicks;
+		sample.thread = threadId();
+		sample.sequence.store(index + 1, std::memory_order_release);
+	}
+
+	bool Profiler::readSample(unsigned long long index, const char *&name, long long &start, long long &end, unsigned int &thread) const {
+		const Sample &sample = ring[index & (capacity - 1)];
+		if (sample.sequence.load(std::memory_order_acquire) != index + 1) return false;
+		name = sample.name;
+		start = sample.start;
+		end = sample.end;
+		thread = sample.thread;
+		// A writer that lapped us while copying changes the sequence.
+		return sample.sequence.load(std::memory_order_acquire) == index + 1;
+	}
+
+	Profiler::Track &Profiler::trackFor(const char *name){
+		// Few distinct names, and literals compare by address.
+		for (size_t i = 0; i < tracks.size(); i++) {
+			if (tracks[i].name == name) return tracks[i];
+		}
+		Track track;
+		track.name = name;
+		track.frameMs.assign(window, 0.0);
+		track.head = 0;
+		track.count = 0;
+		track.current = 0.0;
+		tracks.push_back(track);
+		return tracks.back();
+	}
+
+	void Profiler::EndFrame(){
+		if (ring == NULL) return;
+		const unsigned long long end = writeIndex.load(std::memory_order_acquire);
+		unsigned long long begin = frameStart;
+		if (end - begin > capacity) begin = end - capacity;	// Lost to wrap-around
+		frameStart = end;
+
+		const double msPerTick = 1000.0 / (double)Clock::TicksPerSecond();
+		for (unsigned long long i = begin; i < end; i++) {
+			const char *name;
+			long long start, stop;
+			unsigned int thread;
+			if (!readSample(i, name, start, stop, thread)) continue;
+			trackFor(name).current += (stop - start) * msPerTick;
+		}
+
+		// Every known name gets a value each frame, 0 when it did not run.
+		for (size_t t = 0; t < tracks.size(); t++) {
+			Track &track = tracks[t];
+			track.frameMs[track.head] = track.current;
+			track.head = (track.head + 1) % window;
+			if (track.count < window) track.count++;
+			track.current = 0.0;
+		}
+	}
+
+	void Profiler::Summarize(std::vector<ProfileSummary> &out) const {
+		out.clear();
+		std::vector<double> sorted;
+		for (size_t t = 0; t < tracks.size(); t++) {
+			const Track &track = tracks[t];
+			if (track.count == 0) continue;
+			sorted.clear();
+			for (unsigned int i = 0; i < track.count; i++)
+				sorted.push_back(track.frameMs[(track.head + window - 1 - i) % window]);
+			std::sort(sorted.begin(), sorted.end());
+
+			double sum = 0.0;
+			for (size_t i = 0; i < sorted.size(); i++) sum += sorted[i];
+			size_t p99 = (size_t)(0.99 * (sorted.size() - 1) + 0.5);
+
+			ProfileSummary summary;
+			summary.name = track.name;
+			summary.minMs = sorted.front();
+			summary.avgMs = sum / sorted.size();
+			summary.p99Ms = sorted[p99];
+			summary.maxMs = sorted.back();
+			summary.frames = track.count;
+			out.push_back(summary);
+		}
+	}
+
+	void Profiler::WriteSummary(std::ostream &out) const {
+		std::vector<ProfileSummary> summaries;
+		Summarize(summaries);
+		out << std::fixed << std::setprecision(3);
+		out << std::left << std::setw(24) << "scope" << std::right
+			<< std::setw(10) << "min ms" << std::setw(10) << "avg ms"
+			<< std::setw(10) << "p99 ms" << std::setw(10) << "max ms" << "\n";
+		for (size_t i = 0; i < summaries.size(); i++) {
+			const ProfileSummary &s = summaries[i];
+			out << std::left << std::setw(24) << s.name << std::right
+				<< std::setw(10) << s.minMs << std::setw(10) << s.avgMs
+				<< std::setw(10) << s.p99Ms << std::setw(10) << s.maxMs << "\n";
+		}
+	}
+
+	void Profiler::WriteChromeTrace(std::ostream &out) const {
+		out << "{\"traceEvents\":[";
+		if (ring != NULL) {
+			const unsigned long long end = writeIndex.load(std::memory_order_acquire);
+			const unsigned long long begin = end > capacity ? end - capacity : 0;
+			const double usPerTick = 1000000.0 / (double)Clock::TicksPerSecond();
+			bool first = true;
+			out << std::fixed << std::setprecision(3);
+			for (unsigned long long i = begin; i < end; i++) {
+				const char *name;
+				long long start, stop;
+				unsigned int thread;
+				if (!readSample(i, name, start, stop, thread)) continue;
+				out << (first ? "\n" : ",\n") << "{\"name\":";
+				writeJsonString(out, name);
+				out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread
+					<< ",\"ts\":" << start * usPerTick
+					<< ",\"dur\":" << (stop - start) * usPerTick << "}";
+				first = false;
+			}
+		}
+		out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+	}
+
+	bool Profiler::SaveChromeTrace(const std::string &path) const {
+		std::ofstream file(path.c_str());
+		if (!file) return false;
+		WriteChromeTrace(file);
+		return (bool)file;
+	}
+
+	void Profiler::Clear(){
+		if (ring != NULL) {
+			for (unsigned int i = 0; i < capacity; i++) ring[i].sequence.store(0);
+		}
+		frameStart = writeIndex.load();
+		tracks.clear();
+	}
+
+	Profiler *Profiler::Current(){
+		return currentProfiler;
+	}
+
+	void Profiler::SetCurrent(Profiler *profiler){
+		currentProfiler = profiler;
+	}
+
+	long long ProfileScope::now(){
+		return Clock::Ticks();
+	}
+}
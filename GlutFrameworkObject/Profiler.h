@@ -0,0 +1,191 @@
+///////////////////////////////////////////////////////////////////////////////
+/// GlFrameworkBasic is free software : you can redistribute it and or modify
+/// it under the terms of the GNU General Public License as published by
+/// the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// GlFrameworkBasic is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with GlFrameworkBasic. If not, see <http://www.gnu.org/licenses/>.
+///
+/// Author: Evan Edstrom
+/// Date: 11/17/2013
+/// Website: http://evanedstrom.com/glstart
+/// Email: contact@evanedstrom.com
+///
+///////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+#include <atomic>
+#include <ostream>
+#include <string>
+#include <vector>
+#if defined(GLFRAMEWORK_TRACK_ALLOCATIONS)
+#include "AllocationTracker.h"
+#endif
+
+namespace glFrameworkBasic {
+	/// <summary>Rolling statistics for one named scope, in milliseconds per frame.</summary>
+	struct ProfileSummary
+	{
+		const char *name;
+		double minMs, avgMs, p99Ms, maxMs;
+		unsigned int frames;	// Frames in the rolling window
+	};
+
+	/**
+	* Profiler records timed scopes into a fixed size ring buffer. Any thread
+	* may add samples: a writer claims a slot with one atomic increment and
+	* publishes it with a sequence number, no locks are taken. When the ring
+	* wraps the oldest samples are overwritten.
+	* EndFrame() folds the frame's samples into a rolling per-name window for
+	* Summarize(), and WriteChromeTrace() exports the ring as Chrome trace
+	* events (load in chrome://tracing or Perfetto).
+	* Scopes are opened with ProfileScope or GLFRAMEWORK_PROFILE_SCOPE, which
+	* record into the profiler made current on the calling thread. While the
+	* profiler is disabled a scope costs one branch.
+	* Scope names must be string literals or otherwise outlive the profiler.
+	*/
+	class Profiler
+	{
+	public:
+		/// <summary>Creates a disabled profiler. The ring is allocated on first enable.</summary>
+		/// <param name="capacity">Ring size in samples, rounded up to a power of two.</param>
+		/// <param name="window">Frames kept for Summarize().</param>
+		explicit Profiler(unsigned int capacity = 65536, unsigned int window = 240);
+
+		/// <summary>Destructor. Frees the ring.</summary>
+		~Profiler();
+
+		/// <summary>Start or stop recording. Default disabled.</summary>
+		void SetEnabled(bool doEnable);
+
+		/// <summary>True while recording.</summary>
+		bool IsEnabled() const { return enabled; }
+
+		/// <summary>Adds a finished scope. Thread safe, lock free.</summary>
+		void Record(const char *name, long long startTicks, long long endTicks);
+
+		/// <summary>
+		/// Closes a frame: totals the samples added since the last call per name
+		/// into the rolling window. Call from one thread, between frames.
+		/// </summary>
+		void EndFrame();
+
+		/// <summary>Min, average, 99th percentile and max of each name over the window.</summary>
+		void Summarize(std::vector<ProfileSummary> &out) const;
+
+		/// <summary>Writes Summarize() as a text table, one name per line.</summary>
+		void WriteSummary(std::ostream &out) const;
+
+		/// <summary>Writes the samples in the ring as Chrome trace-event JSON.</summary>
+		void WriteChromeTrace(std::ostream &out) const;
+
+		/// <summary>WriteChromeTrace() to a file. Returns false if it cannot be opened.</summary>
+		bool SaveChromeTrace(const std::string &path) const;
+
+		/// <summary>Drops every sample and the rolling window.</summary>
+		void Clear();
+
+		/// <summary>Profiler scopes on the calling thread record into, or NULL.</summary>
+		static Profiler *Current();
+
+		/// <summary>Makes profiler current on the calling thread. NULL stops recording.</summary>
+		static void SetCurrent(Profiler *profiler);
+
+	private:
+		struct Sample {
+			std::atomic<unsigned long long> sequence;	// Write index + 1 once published
+			const char *name;
+			long long start, end;	// Clock::Ticks()
+			unsigned int thread;	// Small per-thread id for the trace
+		};
+
+		// Per-name frame totals, newest at (head - 1) % window.
+		struct Track {
+			const char *name;
+			std::vector<double> frameMs;
+			unsigned int head, count;
+			double current;			// Total for the frame being collected
+		};
+
+		bool enabled;
+		unsigned int capacity;
+		unsigned int window;
+		Sample *ring;
+		std::atomic<unsigned long long> writeIndex;
+		unsigned long long frameStart;	// writeIndex at the last EndFrame()
+		std::vector<Track> tracks;
+
+		/// <summary>Track for name, created on first use.</summary>
+		Track &trackFor(const char *name);
+
+		/// <summary>Copies out a published sample. False if not written or overwritten.</summary>
+		bool readSample(unsigned long long index, const char *&name, long long &start, long long &end, unsigned int &thread) const;
+
+		// Copy is not allowed, the ring is owned.
+		Profiler(const Profiler &);
+		Profiler &operator=(const Profiler &);
+	};
+
+	/**
+	* ProfileScope times its own lifetime into the current thread's profiler.
+	* Does nothing when no profiler is current or it is disabled.
+	* With GLFRAMEWORK_TRACK_ALLOCATIONS it also names the allocation phase,
+	* whether or not the profiler is enabled.
+	*/
+	class ProfileScope
+	{
+	public:
+		explicit ProfileScope(const char *scopeName)
+		{
+			Profiler *current = Profiler::Current();
+			profiler = (current != NULL && current->IsEnabled()) ? current : NULL;
+			if (profiler != NULL) {
+				name = scopeName;
+				start = now();
+			}
+#if defined(GLFRAMEWORK_TRACK_ALLOCATIONS)
+			previousPhase = AllocationTracker::CurrentPhase();
+			AllocationTracker::SetCurrentPhase(scopeName);
+#endif
+		}
+
+		~ProfileScope()
+		{
+			if (profiler != NULL) profiler->Record(name, start, now());
+#if defined(GLFRAMEWORK_TRACK_ALLOCATIONS)
+			AllocationTracker::SetCurrentPhase(previousPhase);
+#endif
+		}
+
+	private:
+		Profiler *profiler;
+		const char *name;
+		long long start;
+#if defined(GLFRAMEWORK_TRACK_ALLOCATIONS)
+		const char *previousPhase;
+#endif
+
+		static long long now();
+
+		ProfileScope(const ProfileScope &);
+		ProfileScope &operator=(const ProfileScope &);
+	};
+}
+
+// Opens a ProfileScope for the rest of the block. Defining
+// GLFRAMEWORK_NO_PROFILER compiles every scope out.
+#if defined(GLFRAMEWORK_NO_PROFILER)
+#define GLFRAMEWORK_PROFILE_SCOPE(name)
+#else
+#define GLFRAMEWORK_PROFILE_CONCAT2(a, b) a##b
+#define GLFRAMEWORK_PROFILE_CONCAT(a, b) GLFRAMEWORK_PROFILE_CONCAT2(a, b)
+#define GLFRAMEWORK_PROFILE_SCOPE(name) \
+	::glFrameworkBasic::ProfileScope GLFRAMEWORK_PROFILE_CONCAT(profileScope_, __LINE__)(name)
+#endif
@@ -0,0 +1,130 @@
+///////////////////////////////////////////////////////////////////////////////
+/// GlFrameworkBasic is free software : you can redistribute it and or modify
+/// it under the terms of the GNU General Public License as published by
+/// the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// GlFrameworkBasic is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with GlFrameworkBasic. If not, see <http://www.gnu.org/licenses/>.
+///
+/// Author: Evan Edstrom
+/// Date: 11/17/2013
+/// Website: http://evanedstrom.com/glstart
+/// Email: contact@evanedstrom.com
+///
+///////////////////////////////////////////////////////////////////////////////
+
+#include "RenderBatch.h"
+
+namespace glFrameworkBasic {
+	RenderBatch::RenderBatch()
+	{
+		SetColor(1.0f, 1.0f, 1.0f);
+		drawCalls = 0;
+		instancing = false;
+	}
+
+	RenderBatch::~RenderBatch()
+	{
+	}
+
+	void RenderBatch::Begin(){
+		vertices.clear();	// clear() keeps capacity, so later frames reuse it.
+		indices.clear();
+		instances.clear();
+		runs.clear();
+		transform = Transform();
+		if (instancing) instancer.Create();
+	}
+
+	void RenderBatch::SetInstancing(bool doInstance){
+		instancing = doInstance;
+	}
+
+	void RenderBatch::Flush(){
+		drawCalls = 0;
+		if (indices.empty() && instances.empty()) {
+			vertices.clear();
+			runs.clear();
+			return;
+		}
+
+		if (!instances.empty()) instancer.Upload(&instances[0], instances.size());
+
+		// Switch between client vertex arrays and the instancing shader only
+		// where index runs and instance runs alternate.
+		bool clientArrays = false, instanced = false;
+		for (std::vector<Run>::const_iterator i = runs.begin(), e = runs.end(); i != e; ++i) {
+			if (i->shape == NO_SHAPE) {
+				if (instanced) {
+					instancer.End();
+					instanced = false;
+				}
+				if (!clientArrays) {
+					glEnableClientState(GL_VERTEX_ARRAY);
+					glEnableClientState(GL_COLOR_ARRAY);
+					glVertexPointer(3, GL_FLOAT, sizeof(Vertex), &vertices[0].x);
+					glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(Vertex), &vertices[0].r);
+					clientArrays = true;
+				}
+				glDrawElements(i->mode, i->count, GL_UNSIGNED_INT, &indices[i->first]);
+			}
+			else {
+				if (clientArrays) {
+					glDisableClientState(GL_COLOR_ARRAY);
+					glDisableClientState(GL_VERTEX_ARRAY);
+					clientArrays = false;
+				}
+				if (!instanced) {
+					instancer.Begin();
+					instanced = true;
+				}
+				instancer.Draw(i->shape, i->first, i->count);
+			}
+			drawCalls++;
+		}
+
+		if (instanced) instancer.End();
+		if (clientArrays) {
+			glDisableClientState(GL_COLOR_ARRAY);
+			glDisableClientState(GL_VERTEX_ARRAY);
+		}
+
+		vertices.clear();
+		indices.clear();
+		instances.clear();
+		runs.clear();
+	}
+
+	void RenderBatch::SetColor(float r, float g, float b, float a){
+		color[0] = (unsigned char)(r * 255.0f + 0.5f);
+		color[1] = (unsigned char)(g * 255.0f + 0.5f);
+		color[2] = (unsigned char)(b * 255.0f + 0.5f);
+		color[3] = (unsigned char)(a * 255.0f + 0.5f);
+	}
+
+	void RenderBatch::AddTriangleFan(const float *xy, int count){
+		if (count < 3) return;
+		GLuint center = AddVertex(xy[0], xy[1]);
+		GLuint prev = AddVertex(xy[2], xy[3]);
+		for (int i = 2; i < count; i++) {
+			GLuint next = AddVertex(xy[2 * i], xy[2 * i + 1]);
+			AddTriangle(center, prev, next);
+			prev = next;
+		}
+	}
+
+	void RenderBatch::beginRun(GLenum mode, int shape, GLint first){
+		Run run;
+		run.mode = mode;
+		run.shape = shape;
+		run.first = first;
+		run.count = 0;
+		runs.push_back(run);
+	}
+}
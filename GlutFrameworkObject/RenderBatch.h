@@ -0,0 +1,176 @@
+///////////////////////////////////////////////////////////////////////////////
+/// GlFrameworkBasic is free software : you can redistribute it and or modify
+/// it under the terms of the GNU General Public License as published by
+/// the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// GlFrameworkBasic is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with GlFrameworkBasic. If not, see <http://www.gnu.org/licenses/>.
+///
+/// Author: Evan Edstrom
+/// Date: 11/17/2013
+/// Website: http://evanedstrom.com/glstart
+/// Email: contact@evanedstrom.com
+///
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <GL\glut.h>
+#include <vector>
+
+#include "InstanceRenderer.h"
+#include "Transform.h"
+
+namespace glFrameworkBasic {
+	/**
+	* RenderBatch collects world space geometry from many Elements into one
+	* interleaved vertex/color array plus an index array, and draws it with a
+	* handful of glDrawElements calls instead of one glBegin/glEnd and matrix
+	* push per Element. Vertices are transformed on the CPU by the current
+	* transform, which Engine sets from each Element before calling
+	* Element::Submit(). Indexing lets fans and quads share vertices.
+	* Draw order is preserved: a change of primitive type starts a new run.
+	* Storage is kept between frames so a steady scene does not allocate.
+	* With SetInstancing() built-in shapes can instead be added as instances
+	* (AddInstance), which InstanceRenderer draws with one instanced call per
+	* run of the same shape; vertices and instances keep their relative order.
+	*/
+	class RenderBatch
+	{
+	public:
+		/// <summary>Interleaved vertex layout handed to glVertexPointer / glColorPointer.</summary>
+		struct Vertex {
+			float x, y, z;
+			unsigned char r, g, b, a;
+		};
+
+		RenderBatch();
+		~RenderBatch();
+
+		/// <summary>Empties the batch for a new frame. Keeps allocated storage.</summary>
+		void Begin();
+
+		/// <summary>Draws everything submitted since the last Begin/Flush, then empties the batch.</summary>
+		void Flush();
+
+		/// <summary>
+		/// Enable or disable the instanced path. It is set up at the next
+		/// Begin() with the current context; if the context cannot do
+		/// instancing AddInstance() keeps returning false. Default false.
+		/// </summary>
+		void SetInstancing(bool doInstance);
+
+		/// <summary>True when AddInstance() accepts instances.</summary>
+		bool IsInstancing() const { return instancing && instancer.IsCreated(); }
+
+		/// <summary>
+		/// Adds one copy of a built-in shape (InstanceRenderer::Shape) with the
+		/// current transform, tinted by the current color. Returns false, adding
+		/// nothing, when instancing is off or unsupported; add vertices instead.
+		/// </summary>
+		bool AddInstance(int shape)
+		{
+			if (!IsInstancing()) return false;
+			InstanceRenderer::Instance instance;
+			instance.basis[0] = transform.a; instance.basis[1] = transform.b;
+			instance.basis[2] = transform.c; instance.basis[3] = transform.d;
+			instance.offset[0] = transform.tx; instance.offset[1] = transform.ty; instance.offset[2] = transform.z;
+			instance.color[0] = color[0]; instance.color[1] = color[1]; instance.color[2] = color[2]; instance.color[3] = color[3];
+			if (runs.empty() || runs.back().shape != shape) beginRun(0, shape, (GLint)instances.size());
+			instances.push_back(instance);
+			runs.back().count++;
+			return true;
+		}
+
+		/// <summary>Local to world transform applied to following vertices.</summary>
+		void SetTransform(const Transform &t) { transform = t; }
+		const Transform &GetTransform() const { return transform; }
+
+		/// <summary>Color used for following vertices, like glColor3f.</summary>
+		void SetColor(float r, float g, float b, float a = 1.0f);
+
+		/// <summary>
+		/// Adds one vertex in local coordinates with the current color and
+		/// returns its index for AddTriangle / AddQuad / AddLine.
+		/// </summary>
+		GLuint AddVertex(float x, float y)
+		{
+			Vertex v;
+			v.x = transform.X(x, y);
+			v.y = transform.Y(x, y);
+			v.z = transform.z;
+			v.r = color[0]; v.g = color[1]; v.b = color[2]; v.a = color[3];
+			vertices.push_back(v);
+			return (GLuint)(vertices.size() - 1);
+		}
+
+		/// <summary>Adds a triangle from three vertex indices.</summary>
+		void AddTriangle(GLuint v0, GLuint v1, GLuint v2)
+		{
+			addIndex(GL_TRIANGLES, v0); addIndex(GL_TRIANGLES, v1); addIndex(GL_TRIANGLES, v2);
+		}
+
+		/// <summary>Adds a quad (counter clockwise corners) as two triangles.</summary>
+		void AddQuad(GLuint v0, GLuint v1, GLuint v2, GLuint v3)
+		{
+			AddTriangle(v0, v1, v2);
+			AddTriangle(v0, v2, v3);
+		}
+
+		/// <summary>Adds a line segment from two vertex indices.</summary>
+		void AddLine(GLuint v0, GLuint v1)
+		{
+			addIndex(GL_LINES, v0); addIndex(GL_LINES, v1);
+		}
+
+		/// <summary>Adds a triangle fan in local coordinates with the current color.</summary>
+		/// <param name="xy">Packed x, y pairs, center first.</param>
+		/// <param name="count">Number of points in xy, including the center.</param>
+		void AddTriangleFan(const float *xy, int count);
+
+		/// <summary>Number of vertices waiting to be flushed.</summary>
+		size_t VertexCount() const { return vertices.size(); }
+
+		/// <summary>Number of instances waiting to be flushed.</summary>
+		size_t InstanceCount() const { return instances.size(); }
+
+		/// <summary>Number of glDrawElements and instanced draw calls made by the last Flush.</summary>
+		unsigned int DrawCallCount() const { return drawCalls; }
+
+	private:
+		/// <summary>Consecutive indices sharing one primitive mode, or instances of one shape.</summary>
+		struct Run {
+			GLenum mode;
+			int shape;			// Instance shape, NO_SHAPE for an index run
+			GLint first;		// First index or instance
+			GLsizei count;
+		};
+		static const int NO_SHAPE = -1;
+
+		std::vector<Vertex> vertices;
+		std::vector<GLuint> indices;
+		std::vector<InstanceRenderer::Instance> instances;
+		std::vector<Run> runs;
+		Transform transform;
+		unsigned char color[4];
+		unsigned int drawCalls;
+		bool instancing;
+		InstanceRenderer instancer;
+
+		void beginRun(GLenum mode, int shape, GLint first);
+
+		/// <summary>Appends an index, starting a new run when the mode changes.</summary>
+		void addIndex(GLenum mode, GLuint index)
+		{
+			if (runs.empty() || runs.back().mode != mode || runs.back().shape != NO_SHAPE)
+				beginRun(mode, NO_SHAPE, (GLint)indices.size());
+			indices.push_back(index);
+			runs.back().count++;
+		}
+	};
+}
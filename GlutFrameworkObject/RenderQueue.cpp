@@ -0,0 +1,101 @@
+///////////////////////////////////////////////////////////////////////////////
+/// GlFrameworkBasic is free software : you can redistribute it and or modify
+/// it under the terms of the GNU General Public License as published by
+/// the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// GlFrameworkBasic is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with GlFrameworkBasic. If not, see <http://www.gnu.org/licenses/>.
+///
+/// Author: Evan Edstrom
+/// Date: 11/17/2013
+/// Website: http://evanedstrom.com/glstart
+/// Email: contact@evanedstrom.com
+///
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include "RenderQueue.h"
+#include <cstring>
+
+namespace glFrameworkBasic {
+	RenderQueue::RenderQueue()
+	{
+		reused = false;
+	}
+
+	void RenderQueue::Begin(){
+		keys.clear();
+		elements.clear();
+	}
+
+	unsigned long long RenderQueue::MakeKey(unsigned int layer, float depth, unsigned int type, unsigned int material){
+		// Map the float to an unsigned int that sorts the same way: flip all
+		// bits of negatives, only the sign bit of positives.
+		unsigned int bits;
+		memcpy(&bits, &depth, sizeof(bits));
+		bits = (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+		return ((unsigned long long)(layer & 0xffu) << 56)
+			| ((unsigned long long)(bits >> 8) << 32)
+			| ((unsigned long long)(type & 0xffffu) << 16)
+			| (unsigned long long)(material & 0xffffu);
+	}
+
+	void RenderQueue::Sort(){
+		reused = !sorted.empty() && keys == lastKeys && elements == lastElements;
+		if (!reused) {
+			const size_t count = keys.size();
+			entries.resize(count);
+			for (size_t i = 0; i < count; i++) {
+				entries[i].key = keys[i];
+				entries[i].index = (unsigned int)i;
+			}
+			radixSort();
+			sorted.resize(count);
+			for (size_t i = 0; i < count; i++) sorted[i] = elements[entries[i].index];
+		}
+		keys.swap(lastKeys);
+		elements.swap(lastElements);
+	}
+
+	void RenderQueue::radixSort(){
+		const size_t count = entries.size();
+		if (count < 2) return;
+		scratch.resize(count);
+
+		// All eight byte histograms in one pass over the keys.
+		counts.assign(8 * 256, 0);
+		for (size_t i = 0; i < count; i++) {
+			const unsigned long long key = entries[i].key;
+			for (int b = 0; b < 8; b++) counts[b * 256 + ((key >> (b * 8)) & 0xff)]++;
+		}
+
+		Entry *src = &entries[0];
+		Entry *dst = &scratch[0];
+		for (int b = 0; b < 8; b++) {
+			size_t *histogram = &counts[b * 256];
+			const unsigned int first = (unsigned int)((src[0].key >> (b * 8)) & 0xff);
+			if (histogram[first] == count) continue;	// Byte is the same in every key
+
+			size_t offset = 0;
+			for (int v = 0; v < 256; v++) {
+				const size_t n = histogram[v];
+				histogram[v] = offset;
+				offset += n;
+			}
+			for (size_t i = 0; i < count; i++) {
+				const unsigned int v = (unsigned int)((src[i].key >> (b * 8)) & 0xff);
+				dst[histogram[v]++] = src[i];
+			}
+			Entry *swap = src;
+			src = dst;
+			dst = swap;
+		}
+		if (src != &entries[0]) entries.swap(scratch);
+	}
+}
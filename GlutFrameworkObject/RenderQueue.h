@@ -0,0 +1,100 @@
+///////////////////////////////////////////////////////////////////////////////
+/// GlFrameworkBasic is free software : you can redistribute it and or modify
+/// it under the terms of the GNU General Public License as published by
+/// the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// GlFrameworkBasic is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with GlFrameworkBasic. If not, see <http://www.gnu.org/licenses/>.
+///
+/// Author: Evan Edstrom
+/// Date: 11/17/2013
+/// Website: http://evanedstrom.com/glstart
+/// Email: contact@evanedstrom.com
+///
+///////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+#include <cstddef>
+#include <vector>
+
+namespace glFrameworkBasic {
+	class Element;
+
+	/**
+	* RenderQueue orders a frame's elements by a 64 bit sort key before they
+	* are drawn. Keys are built by MakeKey() from, most significant first,
+	* layer, depth, element type and material, so elements stack by layer and
+	* zPos and neighbours share primitive type and GL state: fewer batch runs,
+	* flushes and state changes. Keys are sorted with a stable LSD radix sort,
+	* one histogram pass plus one scatter per key byte that is not constant,
+	* so equal keys keep the order they were added in.
+	* When a frame adds the same elements with the same keys as the previous
+	* one, the previous order is reused without sorting.
+	*/
+	class RenderQueue
+	{
+	public:
+		RenderQueue();
+
+		/// <summary>Empties the queue for a new frame. Keeps allocated storage.</summary>
+		void Begin();
+
+		/// <summary>Adds an element with its sort key.</summary>
+		void Add(unsigned long long key, Element *element)
+		{
+			keys.push_back(key);
+			elements.push_back(element);
+		}
+
+		/// <summary>Sorts the elements added since Begin(), or reuses the last order.</summary>
+		void Sort();
+
+		/// <summary>Elements in key order after Sort().</summary>
+		Element *const *Sorted() const { return sorted.empty() ? NULL : &sorted[0]; }
+
+		/// <summary>Number of elements in the queue.</summary>
+		size_t Size() const { return sorted.size(); }
+
+		/// <summary>True when the last Sort() reused the previous frame's order.</summary>
+		bool LastSortReused() const { return reused; }
+
+		/// <summary>
+		/// Builds a sort key. Lower keys are drawn first: lower layers, then
+		/// lower depth (further back), then grouped by type and material.
+		/// </summary>
+		/// <param name="layer">Draw layer, 0 - 255.</param>
+		/// <param name="depth">zPos, any float. Kept to 24 bits of precision.</param>
+		/// <param name="type">Element type index, 0 - 65535.</param>
+		/// <param name="material">Material (color / texture state) id, 0 - 65535.</param>
+		static unsigned long long MakeKey(unsigned int layer, float depth, unsigned int type, unsigned int material);
+
+	private:
+		/// <summary>Key with the position it was added at.</summary>
+		struct Entry {
+			unsigned long long key;
+			unsigned int index;
+		};
+
+		// This frame's input, swapped with the last frame's after Sort().
+		std::vector<unsigned long long> keys;
+		std::vector<Element *> elements;
+		std::vector<unsigned long long> lastKeys;
+		std::vector<Element *> lastElements;
+
+		std::vector<Entry> entries;		// Radix sort ping-pong buffers
+		std::vector<Entry> scratch;
+		std::vector<size_t> counts;		// Eight byte histograms
+		std::vector<Element *> sorted;
+		bool reused;
+
+		/// <summary>Stable radix sort of entries by key. Uses scratch.</summary>
+		void radixSort();
+	};
+}
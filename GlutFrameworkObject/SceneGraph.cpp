@@ -0,0 +1,217 @@
+///////////////////////////////////////////////////////////////////////////////
+/// GlFrameworkBasic is free software : you can redistribute it and or modify
+/// it under the terms of the GNU General Public License as published by
+/// the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// GlFrameworkBasic is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with GlFrameworkBasic. If not, see <http://www.gnu.org/licenses/>.
+///
+/// Author: Evan Edstrom
+/// Date: 11/17/2013
+/// Website: http://evanedstrom.com/glstart
+/// Email: contact@evanedstrom.com
+///
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include "SceneGraph.h"
+#include "Element.h"
+
+namespace glFrameworkBasic {
+	const unsigned int SceneGraph::NO_PARENT;
+
+	SceneGraph::SceneGraph() : anyDirty(false)
+	{
+		laidOut = 0;
+		liveCount = 0;
+		lastUpdateCount = 0;
+		currentStamp = 0;
+		layoutDirty = false;
+	}
+
+	SceneGraph::~SceneGraph()
+	{
+		for (size_t i = 0; i < nodes.size(); i++) {
+			if (nodes[i] == NULL) continue;
+			nodes[i]->graph = NULL;
+			nodes[i]->parent = NULL;
+		}
+	}
+
+	void SceneGraph::addNode(Element *element){
+		if (element->graph == this) return;
+		element->graph = this;
+		element->graphNode = (unsigned int)nodes.size();
+		nodes.push_back(element);
+		parentIndex.push_back(NO_PARENT);
+		firstChild.push_back(0);
+		childCount.push_back(0);
+		world.push_back(Transform());
+		previous.push_back(Transform());
+		stamp.push_back(0);
+		localDirty.push_back(1);
+		anyDirty = true;
+		liveCount++;
+		layoutDirty = true;
+	}
+
+	bool SceneGraph::Attach(Element *child, Element *parent){
+		if (child == NULL) return false;
+		if (parent == NULL) {
+			Detach(child);
+			return true;
+		}
+		for (const Element *e = parent; e != NULL; e = e->parent) {
+			if (e == child) return false;	// Would make a cycle
+		}
+		if (child->graph != NULL && child->graph != this) return false;	// Another engine's element
+		addNode(child);
+		addNode(parent);
+		child->parent = parent;
+		parentIndex[child->graphNode] = parent->graphNode;
+		localDirty[child->graphNode] = 1;
+		anyDirty = true;
+		relinked.push_back(child->graphNode);
+		layoutDirty = true;
+		return true;
+	}
+
+	void SceneGraph::Detach(Element *child){
+		if (child == NULL || child->graph != this || child->parent == NULL) return;
+		child->parent = NULL;
+		parentIndex[child->graphNode] = NO_PARENT;
+		localDirty[child->graphNode] = 1;
+		anyDirty = true;
+		relinked.push_back(child->graphNode);
+		layoutDirty = true;
+	}
+
+	void SceneGraph::Remove(Element *element){
+		if (element == NULL || element->graph != this) return;
+		const unsigned int node = element->graphNode;
+
+		// Children: the laid out range, plus nodes added or relinked since.
+		std::vector<unsigned int> candidates;
+		if (node < laidOut) {
+			for (unsigned int i = 0; i < childCount[node]; i++) candidates.push_back(firstChild[node] + i);
+		}
+		for (size_t i = laidOut; i < nodes.size(); i++) candidates.push_back((unsigned int)i);
+		candidates.insert(candidates.end(), relinked.begin(), relinked.end());
+		for (size_t i = 0; i < candidates.size(); i++) {
+			Element *child = nodes[candidates[i]];
+			if (child != NULL && child->parent == element) Detach(child);
+		}
+
+		element->parent = NULL;
+		element->graph = NULL;
+		nodes[node] = NULL;
+		parentIndex[node] = NO_PARENT;
+		liveCount--;
+		layoutDirty = true;
+	}
+
+	void SceneGraph::relayout(){
+		const size_t n = nodes.size();
+
+		// Count children per node, then give each parent a contiguous range.
+		std::vector<unsigned int> counts(n, 0), starts(n + 1, 0);
+		for (size_t i = 0; i < n; i++) {
+			if (nodes[i] != NULL && parentIndex[i] != NO_PARENT) counts[parentIndex[i]]++;
+		}
+		for (size_t i = 0; i < n; i++) starts[i + 1] = starts[i] + counts[i];
+		std::vector<unsigned int> children(starts[n]), fill(starts.begin(), starts.end() - 1);
+		for (size_t i = 0; i < n; i++) {
+			if (nodes[i] != NULL && parentIndex[i] != NO_PARENT) children[fill[parentIndex[i]]++] = (unsigned int)i;
+		}
+
+		// Breadth first from the roots.
+		std::vector<unsigned int> order;
+		order.reserve(liveCount);
+		for (size_t i = 0; i < n; i++) {
+			if (nodes[i] != NULL && parentIndex[i] == NO_PARENT) order.push_back((unsigned int)i);
+		}
+		for (size_t k = 0; k < order.size(); k++) {
+			const unsigned int old = order[k];
+			for (unsigned int c = starts[old]; c < starts[old + 1]; c++) order.push_back(children[c]);
+		}
+
+		std::vector<Element *> newNodes(order.size());
+		std::vector<unsigned int> newParent(order.size()), newFirst(order.size()), newCount(order.size());
+		std::vector<Transform> newWorld(order.size()), newPrevious(order.size());
+		std::vector<unsigned int> newStamp(order.size());
+		std::vector<unsigned char> newDirty(order.size());
+		std::vector<unsigned int> newIndex(n, NO_PARENT);
+		for (size_t k = 0; k < order.size(); k++) newIndex[order[k]] = (unsigned int)k;
+		for (size_t k = 0; k < order.size(); k++) {
+			const unsigned int old = order[k];
+			newNodes[k] = nodes[old];
+			newNodes[k]->graphNode = (unsigned int)k;
+			newParent[k] = parentIndex[old] == NO_PARENT ? NO_PARENT : newIndex[parentIndex[old]];
+			newWorld[k] = world[old];
+			newPrevious[k] = previous[old];
+			newStamp[k] = stamp[old];
+			newDirty[k] = localDirty[old];
+			newCount[k] = starts[old + 1] - starts[old];
+		}
+		// The roots come first, then the children of each node in node order.
+		unsigned int next = 0;
+		for (size_t k = 0; k < order.size(); k++) {
+			if (newParent[k] == NO_PARENT) next++;
+		}
+		for (size_t k = 0; k < order.size(); k++) {
+			newFirst[k] = next;
+			next += newCount[k];
+		}
+
+		nodes.swap(newNodes);
+		parentIndex.swap(newParent);
+		firstChild.swap(newFirst);
+		childCount.swap(newCount);
+		world.swap(newWorld);
+		previous.swap(newPrevious);
+		stamp.swap(newStamp);
+		localDirty.swap(newDirty);
+		relinked.clear();
+		laidOut = nodes.size();
+		layoutDirty = false;
+	}
+
+	void SceneGraph::Update(){
+		if (layoutDirty) relayout();
+		lastUpdateCount = 0;
+		if (!anyDirty.load(std::memory_order_relaxed)) return;
+		anyDirty.store(false, std::memory_order_relaxed);
+		currentStamp++;
+
+		// Parents come first, so a parent recomputed in this pass is seen by
+		// its children through its stamp.
+		const size_t n = nodes.size();
+		for (size_t i = 0; i < n; i++) {
+			const unsigned int p = parentIndex[i];
+			if (!localDirty[i] && (p == NO_PARENT || stamp[p] != currentStamp)) continue;
+			localDirty[i] = 0;
+			const Transform local = nodes[i]->GetTransform();
+			const Transform updated = p == NO_PARENT ? local : world[p] * local;
+			previous[i] = stamp[i] != 0 ? world[i] : updated;
+			world[i] = updated;
+			stamp[i] = currentStamp;
+			lastUpdateCount++;
+		}
+	}
+
+	const Transform &SceneGraph::World(const Element *element) const {
+		return world[element->graphNode];
+	}
+
+	Transform SceneGraph::ParentWorld(const Element *element, float alpha) const {
+		const unsigned int p = parentIndex[element->graphNode];
+		if (alpha >= 1.0f || stamp[p] != currentStamp) return world[p];
+		return Transform::Lerp(previous[p], world[p], alpha);
+	}
+}
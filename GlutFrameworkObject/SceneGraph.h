@@ -0,0 +1,128 @@
+///////////////////////////////////////////////////////////////////////////////
+/// GlFrameworkBasic is free software : you can redistribute it and or modify
+/// it under the terms of the GNU General Public License as published by
+/// the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// GlFrameworkBasic is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with GlFrameworkBasic. If not, see <http://www.gnu.org/licenses/>.
+///
+/// Author: Evan Edstrom
+/// Date: 11/17/2013
+/// Website: http://evanedstrom.com/glstart
+/// Email: contact@evanedstrom.com
+///
+///////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+#include <atomic>
+#include <vector>
+
+#include "Transform.h"
+
+namespace glFrameworkBasic {
+	class Element;
+
+	/**
+	* SceneGraph holds parent / child links between Elements. An attached
+	* element's position, scale and angle are relative to its parent, and its
+	* world transform is cached here. Nodes are kept breadth first in flat
+	* arrays, parents before children, so Update() is one forward pass that
+	* only does matrix work for nodes whose own transform changed (see
+	* markDirty) or whose parent was recomputed in the same pass.
+	* Attaching and removing only flag the layout; it is rebuilt at the next
+	* Update(). Node indices are stable in between.
+	*/
+	class SceneGraph
+	{
+	public:
+		SceneGraph();
+
+		/// <summary>Destructor. Detaches the elements still in the graph.</summary>
+		~SceneGraph();
+
+		/// <summary>
+		/// Makes child's transform relative to parent. A NULL parent detaches.
+		/// Returns false, changing nothing, if parent is child or one of its
+		/// descendants.
+		/// </summary>
+		bool Attach(Element *child, Element *parent);
+
+		/// <summary>Makes child a root again; its transform is in world space.</summary>
+		void Detach(Element *child);
+
+		/// <summary>Takes an element out of the graph. Its children become roots.</summary>
+		void Remove(Element *element);
+
+		/// <summary>
+		/// Rebuilds the layout if needed, then recomputes the world transforms
+		/// of changed nodes and their descendants.
+		/// </summary>
+		void Update();
+
+		/// <summary>Number of elements in the graph.</summary>
+		size_t Size() const { return liveCount; }
+
+		/// <summary>World transforms recomputed by the last Update().</summary>
+		size_t LastUpdateCount() const { return lastUpdateCount; }
+
+		/// <summary>Cached world transform of an element in the graph, as of the last Update().</summary>
+		const Transform &World(const Element *element) const;
+
+		/// <summary>
+		/// World transform of an attached element's parent, blended by alpha
+		/// from its value before the last Update() when that Update() moved it.
+		/// </summary>
+		Transform ParentWorld(const Element *element, float alpha) const;
+
+	private:
+		friend class Element;
+
+		static const unsigned int NO_PARENT = 0xffffffffu;
+
+		// One entry per node, breadth first after a relayout. Nodes added
+		// since then are appended; removed ones are NULL until the next one.
+		std::vector<Element *> nodes;
+		std::vector<unsigned int> parentIndex;	// NO_PARENT for roots
+		std::vector<unsigned int> firstChild;	// Children are contiguous after a relayout
+		std::vector<unsigned int> childCount;
+		std::vector<Transform> world;
+		std::vector<Transform> previous;		// World before the Update() that last changed it
+		std::vector<unsigned int> stamp;		// Update() that last changed it, 0 never
+		std::vector<unsigned char> localDirty;	// Own transform changed, written by markDirty
+		std::vector<unsigned int> relinked;		// Nodes whose parent changed since the relayout
+
+		size_t laidOut;				// Nodes covered by the last relayout
+		size_t liveCount;
+		size_t lastUpdateCount;
+		unsigned int currentStamp;
+		bool layoutDirty;
+		std::atomic<bool> anyDirty;
+
+		/// <summary>
+		/// Flags a node whose element changed position, scale or angle. Only
+		/// touches that node's byte, so parallel Move() calls may use it.
+		/// </summary>
+		void markDirty(unsigned int node)
+		{
+			localDirty[node] = 1;
+			anyDirty.store(true, std::memory_order_relaxed);
+		}
+
+		/// <summary>Adds a node for element if it has none.</summary>
+		void addNode(Element *element);
+
+		/// <summary>Sorts the nodes breadth first and drops removed ones.</summary>
+		void relayout();
+
+		// Copy is not allowed, elements point back at this graph.
+		SceneGraph(const SceneGraph &);
+		SceneGraph &operator=(const SceneGraph &);
+	};
+}
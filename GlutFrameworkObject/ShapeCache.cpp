@@ -0,0 +1,91 @@
+///////////////////////////////////////////////////////////////////////////////
+/// GlFrameworkBasic is free software : you can redistribute it and or modify
+/// it under the terms of the GNU General Public License as published by
+/// the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// GlFrameworkBasic is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with GlFrameworkBasic. If not, see <http://www.gnu.org/licenses/>.
+///
+/// Author: Evan Edstrom
+/// Date: 11/17/2013
+/// Website: http://evanedstrom.com/glstart
+/// Email: contact@evanedstrom.com
+///
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ShapeCache.h"
+#include "Platform.h"
+#include <cmath>
+
+namespace glFrameworkBasic {
+	namespace {
+		// Segments per level of detail. The last matches the original Circle::Draw.
+		const int circleSegments[ShapeCache::CIRCLE_LOD_COUNT] = { 8, 12, 16, 24, 32, 48, 64, 100 };
+		const int MAX_SEGMENTS = 100;
+
+		/// Tables are built during static initialization, before any thread
+		/// can draw, so lookups need no locking.
+		struct CircleTables {
+			GLfloat points[ShapeCache::CIRCLE_LOD_COUNT][(MAX_SEGMENTS + 2) * 2];
+			ShapeMesh meshes[ShapeCache::CIRCLE_LOD_COUNT];
+			float maxRadius[ShapeCache::CIRCLE_LOD_COUNT];
+
+			CircleTables()
+			{
+				const double pi = 3.14159265358979;
+				for (int lod = 0; lod < ShapeCache::CIRCLE_LOD_COUNT; lod++) {
+					const int n = circleSegments[lod];
+					GLfloat *xy = points[lod];
+					xy[0] = 0.0f; xy[1] = 0.0f;		// Center of circle
+					for (int i = 0; i <= n; i++) {	// Last vertex same as first vertex
+						const double angle = (i % n) * 2.0 * pi / n;
+						xy[2 + 2 * i] = (GLfloat)(cos(angle) * 0.5);
+						xy[3 + 2 * i] = (GLfloat)(sin(angle) * 0.5);
+					}
+					meshes[lod].xy = xy;
+					meshes[lod].count = n + 2;
+					meshes[lod].segments = n;
+
+					// Sagitta r * (1 - cos(pi / n)) ~ r * pi^2 / (2 n^2) stays
+					// under half a pixel up to this radius.
+					maxRadius[lod] = (float)(n * n / (pi * pi));
+				}
+			}
+		};
+
+		const CircleTables circleTables;
+
+		GLFRAMEWORK_THREAD_LOCAL float currentPixelsPerUnit = 1.0f;
+	}
+
+	const ShapeMesh &ShapeCache::Circle(int lod){
+		if (lod < 0) lod = 0;
+		if (lod >= CIRCLE_LOD_COUNT) lod = CIRCLE_LOD_COUNT - 1;
+		return circleTables.meshes[lod];
+	}
+
+	int ShapeCache::CircleLod(float radiusPixels){
+		for (int lod = 0; lod < CIRCLE_LOD_COUNT - 1; lod++) {
+			if (radiusPixels <= circleTables.maxRadius[lod]) return lod;
+		}
+		return CIRCLE_LOD_COUNT - 1;
+	}
+
+	const ShapeMesh &ShapeCache::CircleForRadius(float radiusPixels){
+		return circleTables.meshes[CircleLod(radiusPixels)];
+	}
+
+	void ShapeCache::SetPixelsPerUnit(float pixelsPerUnit){
+		currentPixelsPerUnit = pixelsPerUnit;
+	}
+
+	float ShapeCache::PixelsPerUnit(){
+		return currentPixelsPerUnit;
+	}
+}
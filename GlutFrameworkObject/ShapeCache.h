@@ -0,0 +1,65 @@
+///////////////////////////////////////////////////////////////////////////////
+/// GlFrameworkBasic is free software : you can redistribute it and or modify
+/// it under the terms of the GNU General Public License as published by
+/// the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// GlFrameworkBasic is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with GlFrameworkBasic. If not, see <http://www.gnu.org/licenses/>.
+///
+/// Author: Evan Edstrom
+/// Date: 11/17/2013
+/// Website: http://evanedstrom.com/glstart
+/// Email: contact@evanedstrom.com
+///
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <GL\glut.h>
+
+namespace glFrameworkBasic {
+	/// <summary>Precomputed triangle fan: center first, last ring point repeats the first.</summary>
+	struct ShapeMesh {
+		const GLfloat *xy;	// Packed x, y pairs
+		int count;			// Number of points, including the center
+		int segments;		// Number of ring segments
+	};
+
+	/**
+	* ShapeCache holds tessellated primitives computed once at startup, so
+	* elements no longer call cos() and sin() every frame. Circles are kept at
+	* several levels of detail; CircleForRadius() picks the coarsest one whose
+	* edge error stays under half a pixel for the projected radius.
+	* The pixels-per-unit scale is set by Engine (from MatrixProjectionScale
+	* and the viewport in reshape) and, like the GL context, is per thread.
+	*/
+	class ShapeCache
+	{
+	public:
+		/// <summary>Number of circle levels of detail.</summary>
+		static const int CIRCLE_LOD_COUNT = 8;
+
+		/// <summary>
+		/// Circle of diameter 1 centered on the origin (the Circle element's
+		/// geometry). lod 0 is the coarsest, CIRCLE_LOD_COUNT - 1 has 100 segments.
+		/// </summary>
+		static const ShapeMesh &Circle(int lod);
+
+		/// <summary>Level of detail for a circle covering radiusPixels on screen.</summary>
+		static int CircleLod(float radiusPixels);
+
+		/// <summary>Shortcut for Circle(CircleLod(radiusPixels)).</summary>
+		static const ShapeMesh &CircleForRadius(float radiusPixels);
+
+		/// <summary>Set how many window pixels one world unit covers.</summary>
+		static void SetPixelsPerUnit(float pixelsPerUnit);
+
+		/// <summary>Window pixels covered by one world unit. Default 1.</summary>
+		static float PixelsPerUnit();
+	};
+}
@@ -0,0 +1,125 @@
+///////////////////////////////////////////////////////////////////////////////
+/// GlFrameworkBasic is free software : you can redistribute it and or modify
+/// it under the terms of the GNU General Public License as published by
+/// the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// GlFrameworkBasic is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with GlFrameworkBasic. If not, see <http://www.gnu.org/licenses/>.
+///
+/// Author: Evan Edstrom
+/// Date: 11/17/2013
+/// Website: http://evanedstrom.com/glstart
+/// Email: contact@evanedstrom.com
+///
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <cstdlib>
+#include <cstring>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__SSE__)
+#define GLFRAMEWORK_SSE 1
+#include <xmmintrin.h>
+#endif
+#if defined(__AVX__)
+#define GLFRAMEWORK_AVX 1
+#include <immintrin.h>
+#endif
+
+namespace glFrameworkBasic {
+	/// Lane count every SIMD kernel is padded to (one AVX register of floats).
+	const size_t SIMD_WIDTH = 8;
+
+	/// <summary>Rounds count up to a whole number of SIMD lanes.</summary>
+	inline size_t SimdRoundUp(size_t count)
+	{
+		return (count + SIMD_WIDTH - 1) & ~(SIMD_WIDTH - 1);
+	}
+
+	/**
+	* Growable float array aligned for SSE/AVX loads. Capacity is always a
+	* multiple of SIMD_WIDTH and unused lanes are kept zeroed, so kernels may
+	* run over SimdRoundUp(size) elements without a scalar tail.
+	*/
+	class AlignedFloatArray
+	{
+	public:
+		AlignedFloatArray() : data(NULL), capacity(0) {}
+		~AlignedFloatArray() { release(data); }
+
+		float *Data() { return data; }
+		const float *Data() const { return data; }
+		float &operator[](size_t i) { return data[i]; }
+		const float &operator[](size_t i) const { return data[i]; }
+		size_t Capacity() const { return capacity; }
+
+		/// <summary>Grows to hold at least count floats, new lanes zeroed.</summary>
+		void Reserve(size_t count)
+		{
+			if (count <= capacity) return;
+			size_t newCapacity = capacity ? capacity : SIMD_WIDTH;
+			while (newCapacity < count) newCapacity *= 2;
+			float *grown = allocate(newCapacity);
+			if (data != NULL) memcpy(grown, data, capacity * sizeof(float));
+			memset(grown + capacity, 0, (newCapacity - capacity) * sizeof(float));
+			release(data);
+			data = grown;
+			capacity = newCapacity;
+		}
+
+	private:
+		float *data;
+		size_t capacity;
+
+		static float *allocate(size_t count)
+		{
+#if defined(_MSC_VER)
+			return (float *)_aligned_malloc(count * sizeof(float), 32);
+#else
+			void *p = NULL;
+			if (posix_memalign(&p, 32, count * sizeof(float)) != 0) return NULL;
+			return (float *)p;
+#endif
+		}
+
+		static void release(float *p)
+		{
+#if defined(_MSC_VER)
+			_aligned_free(p);
+#else
+			free(p);
+#endif
+		}
+
+		// Copy is not allowed, the buffer is owned.
+		AlignedFloatArray(const AlignedFloatArray &);
+		AlignedFloatArray &operator=(const AlignedFloatArray &);
+	};
+
+	/// <summary>
+	/// dst[i] += src[i] * scale over count floats (count a multiple of
+	/// SIMD_WIDTH, pointers 32 byte aligned). Uses AVX or SSE when available.
+	/// </summary>
+	inline void SimdMultiplyAdd(float *dst, const float *src, float scale, size_t count)
+	{
+		size_t i = 0;
+#if defined(GLFRAMEWORK_AVX)
+		const __m256 s8 = _mm256_set1_ps(scale);
+		for (; i + 8 <= count; i += 8)
+			_mm256_store_ps(dst + i, _mm256_add_ps(_mm256_load_ps(dst + i), _mm256_mul_ps(_mm256_load_ps(src + i), s8)));
+#endif
+#if defined(GLFRAMEWORK_SSE)
+		const __m128 s4 = _mm_set1_ps(scale);
+		for (; i + 4 <= count; i += 4)
+			_mm_store_ps(dst + i, _mm_add_ps(_mm_load_ps(dst + i), _mm_mul_ps(_mm_load_ps(src + i), s4)));
+#endif
+		for (; i < count; i++)
+			dst[i] += src[i] * scale;
+	}
+}
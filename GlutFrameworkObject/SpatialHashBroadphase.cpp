@@ -0,0 +1,157 @@
+///////////////////////////////////////////////////////////////////////////////
+/// GlFrameworkBasic is free software : you can redistribute it and or modify
+/// it under the terms of the GNU General Public License as published by
+/// the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// GlFrameworkBasic is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with GlFrameworkBasic. If not, see <http://www.gnu.org/licenses/>.
+///
+/// Author: Evan Edstrom
+/// Date: 11/17/2013
+/// Website: http://evanedstrom.com/glstart
+/// Email: contact@evanedstrom.com
+///
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SpatialHashBroadphase.h"
+
+namespace glFrameworkBasic {
+	SpatialHashBroadphase::SpatialHashBroadphase(float size)
+	{
+		bucketMask = 0;
+		dense = false;
+		minCellX = 0; minCellY = 0;
+		gridWidth = 0; gridHeight = 0;
+		SetCellSize(size);
+	}
+
+	void SpatialHashBroadphase::SetCellSize(float size){
+		cellSize = size > 0.0f ? size : 1.0f;
+		inverseCellSize = 1.0f / cellSize;
+	}
+
+	void SpatialHashBroadphase::Update(const std::vector<Element *> &elements){
+		items.assign(elements.begin(), elements.end());
+		entries.clear();
+		largeEntries.clear();
+
+		for (unsigned int i = 0; i < items.size(); i++) {
+			Entry e;
+			e.box = items[i]->GetWorldBounds();
+			e.item = i;
+			e.cx = cellOf(e.box.minX);
+			e.cy = cellOf(e.box.minY);
+			if (e.box.maxX - e.box.minX > cellSize || e.box.maxY - e.box.minY > cellSize)
+				largeEntries.push_back(e);
+			else
+				entries.push_back(e);
+		}
+
+		// Dense row-major cells when the occupied area is small enough,
+		// otherwise a power of two of hashed buckets, about two per entry.
+		unsigned int bucketCount = 16;
+		dense = false;
+		if (!entries.empty()) {
+			int maxCellX = entries[0].cx, maxCellY = entries[0].cy;
+			minCellX = maxCellX; minCellY = maxCellY;
+			for (size_t i = 1; i < entries.size(); i++) {
+				const Entry &e = entries[i];
+				if (e.cx < minCellX) minCellX = e.cx;
+				if (e.cx > maxCellX) maxCellX = e.cx;
+				if (e.cy < minCellY) minCellY = e.cy;
+				if (e.cy > maxCellY) maxCellY = e.cy;
+			}
+			const double area = ((double)maxCellX - minCellX + 1) * ((double)maxCellY - minCellY + 1);
+			if (area <= 4.0 * entries.size() + 1024.0) {
+				dense = true;
+				gridWidth = maxCellX - minCellX + 1;
+				gridHeight = maxCellY - minCellY + 1;
+				bucketCount = (unsigned int)(gridWidth * gridHeight);
+			}
+		}
+		if (!dense) {
+			while (bucketCount < entries.size() * 2) bucketCount *= 2;
+			bucketMask = bucketCount - 1;
+		}
+
+		// Counting sort of entries by bucket.
+		bucketStart.assign(bucketCount + 1, 0);
+		for (size_t i = 0; i < entries.size(); i++)
+			bucketStart[bucketOf(entries[i].cx, entries[i].cy) + 1]++;
+		for (unsigned int b = 0; b < bucketCount; b++)
+			bucketStart[b + 1] += bucketStart[b];
+		sorted.resize(entries.size());
+		for (size_t i = 0; i < entries.size(); i++)
+			sorted[bucketStart[bucketOf(entries[i].cx, entries[i].cy)]++] = entries[i];
+		// Cursors now hold each bucket's end; shift back to starts.
+		for (unsigned int b = bucketCount; b > 0; b--)
+			bucketStart[b] = bucketStart[b - 1];
+		bucketStart[0] = 0;
+	}
+
+	void SpatialHashBroadphase::checkCell(const Entry &e, int cx, int cy, bool sameCell, unsigned int first, std::vector<ElementPair> &pairs) const {
+		const int bucket = bucketOf(cx, cy);
+		if (bucket < 0) return;		// Off the dense grid, nothing there
+		const unsigned int b = (unsigned int)bucket;
+		const unsigned int end = bucketStart[b + 1];
+		for (unsigned int j = sameCell ? first : bucketStart[b]; j < end; j++) {
+			const Entry &o = sorted[j];
+			if (o.cx != cx || o.cy != cy) continue;	// Hash collision
+			if (!e.box.Overlaps(o.box)) continue;
+			ElementPair p = { items[e.item], items[o.item] };
+			pairs.push_back(p);
+		}
+	}
+
+	void SpatialHashBroadphase::FindPairs(std::vector<ElementPair> &pairs){
+		pairs.clear();
+
+		for (unsigned int i = 0; i < sorted.size(); i++) {
+			const Entry &e = sorted[i];
+			// Later entries of the same cell, then half of the neighbors so
+			// each pair of cells is visited from one side only.
+			checkCell(e, e.cx, e.cy, true, i + 1, pairs);
+			checkCell(e, e.cx + 1, e.cy, false, 0, pairs);
+			checkCell(e, e.cx - 1, e.cy + 1, false, 0, pairs);
+			checkCell(e, e.cx, e.cy + 1, false, 0, pairs);
+			checkCell(e, e.cx + 1, e.cy + 1, false, 0, pairs);
+		}
+
+		// Large elements against everything else; a pair of two large
+		// elements is reported by the first one.
+		for (size_t l = 0; l < largeEntries.size(); l++) {
+			const Entry &big = largeEntries[l];
+
+			// Small elements are filed by their lower left corner, which can
+			// sit up to one cell left of or below the large element.
+			const int x0 = cellOf(big.box.minX) - 1, x1 = cellOf(big.box.maxX);
+			const int y0 = cellOf(big.box.minY) - 1, y1 = cellOf(big.box.maxY);
+			if ((double)(x1 - x0 + 1) * (y1 - y0 + 1) < (double)entries.size()) {
+				for (int cy = y0; cy <= y1; cy++)
+					for (int cx = x0; cx <= x1; cx++)
+						checkCell(big, cx, cy, false, 0, pairs);
+			}
+			else {
+				for (size_t i = 0; i < entries.size(); i++) {
+					if (big.box.Overlaps(entries[i].box)) {
+						ElementPair p = { items[big.item], items[entries[i].item] };
+						pairs.push_back(p);
+					}
+				}
+			}
+
+			for (size_t k = l + 1; k < largeEntries.size(); k++) {
+				if (big.box.Overlaps(largeEntries[k].box)) {
+					ElementPair p = { items[big.item], items[largeEntries[k].item] };
+					pairs.push_back(p);
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,92 @@
+///////////////////////////////////////////////////////////////////////////////
+/// GlFrameworkBasic is free software : you can redistribute it and or modify
+/// it under the terms of the GNU General Public License as published by
+/// the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// GlFrameworkBasic is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with GlFrameworkBasic. If not, see <http://www.gnu.org/licenses/>.
+///
+/// Author: Evan Edstrom
+/// Date: 11/17/2013
+/// Website: http://evanedstrom.com/glstart
+/// Email: contact@evanedstrom.com
+///
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <vector>
+
+#include "Aabb.h"
+#include "Broadphase.h"
+
+namespace glFrameworkBasic {
+	/**
+	* Uniform grid broadphase, best when elements are of similar size. Each
+	* element is filed under the one cell holding its lower left corner; with
+	* elements no bigger than a cell, any overlapping element is then in the
+	* same or a neighboring cell, and only half the neighbors need checking
+	* for each pair to be found once. The grid is rebuilt every Update() with
+	* a counting sort, linear in the number of elements. When the occupied
+	* area is compact the buckets are the grid cells themselves in row order,
+	* so neighbor lookups stream through memory; sparse worlds fall back to
+	* hashed buckets.
+	* Pick a cell size a little over the typical element diameter. Elements
+	* bigger than a cell are kept aside and tested against everything.
+	*/
+	class SpatialHashBroadphase : public Broadphase
+	{
+	public:
+		/// <summary>Creates a grid with square cells of cellSize world units.</summary>
+		explicit SpatialHashBroadphase(float cellSize);
+
+		/// <summary>Set cell size in world units. Applies from the next Update().</summary>
+		void SetCellSize(float size);
+
+		void Update(const std::vector<Element *> &elements);
+		void FindPairs(std::vector<ElementPair> &pairs);
+
+	private:
+		/// <summary>One element filed under its cell.</summary>
+		struct Entry {
+			int cx, cy;
+			unsigned int item;
+			Aabb box;
+		};
+
+		float cellSize;
+		float inverseCellSize;
+
+		std::vector<Element *> items;
+		std::vector<Entry> entries;			// Unsorted, in item order
+		std::vector<Entry> sorted;			// Grouped by bucket
+		std::vector<Entry> largeEntries;	// Elements bigger than a cell
+		std::vector<unsigned int> bucketStart;	// Bucket b is sorted[bucketStart[b], bucketStart[b + 1])
+		unsigned int bucketMask;	// Hashed mode bucket mask
+
+		bool dense;					// Buckets are grid cells, not hashes
+		int minCellX, minCellY;		// Dense grid origin, in cells
+		int gridWidth, gridHeight;	// Dense grid size, in cells
+
+		int cellOf(float v) const { return (int)floor(v * inverseCellSize); }
+
+		/// <summary>Bucket holding cell (cx, cy), or -1 if outside the dense grid.</summary>
+		int bucketOf(int cx, int cy) const
+		{
+			if (dense) {
+				const int x = cx - minCellX, y = cy - minCellY;
+				if (x < 0 || y < 0 || x >= gridWidth || y >= gridHeight) return -1;
+				return y * gridWidth + x;
+			}
+			return (int)((((unsigned int)cx * 73856093u) ^ ((unsigned int)cy * 19349663u)) & bucketMask);
+		}
+
+		/// <summary>Reports overlaps between e and entries of cell (cx, cy), from sorted index first on.</summary>
+		void checkCell(const Entry &e, int cx, int cy, bool sameCell, unsigned int first, std::vector<ElementPair> &pairs) const;
+	};
+}
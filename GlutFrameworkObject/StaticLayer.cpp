@@ -0,0 +1,125 @@
+///////////////////////////////////////////////////////////////////////////////
+/// GlFrameworkBasic is free software : you can redistribute it and or modify
+/// it under the terms of the GNU General Public License as published by
+/// the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// GlFrameworkBasic is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with GlFrameworkBasic. If not, see <http://www.gnu.org/licenses/>.
+///
+/// Author: Evan Edstrom
+/// Date: 11/17/2013
+/// Website: http://evanedstrom.com/glstart
+/// Email: contact@evanedstrom.com
+///
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include "StaticLayer.h"
+#include "GlExtensions.h"
+
+namespace glFrameworkBasic {
+	StaticLayer::StaticLayer()
+	{
+		framebuffer = 0;
+		texture = 0;
+		width = 0;
+		height = 0;
+		valid = false;
+	}
+
+	StaticLayer::~StaticLayer()
+	{
+		// The context may already be gone at exit; only free what we made.
+		if (framebuffer != 0 || texture != 0) Release();
+	}
+
+	bool StaticLayer::IsSupported() const {
+		return GlExtensions::HasFramebuffers();
+	}
+
+	bool StaticLayer::IsValid(int w, int h) const {
+		return valid && w == width && h == height;
+	}
+
+	bool StaticLayer::BeginRender(int w, int h){
+		valid = false;
+		if (!IsSupported() || w <= 0 || h <= 0) return false;
+
+		if (framebuffer == 0 || w != width || h != height) {
+			Release();
+			width = w;
+			height = h;
+
+			glGenTextures(1, &texture);
+			glBindTexture(GL_TEXTURE_2D, texture);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);	// Pixel exact, same size as the window
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+			glBindTexture(GL_TEXTURE_2D, 0);
+
+			GlExtensions::GenFramebuffers(1, &framebuffer);
+			GlExtensions::BindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+			GlExtensions::FramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
+			if (GlExtensions::CheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+				GlExtensions::BindFramebuffer(GL_FRAMEBUFFER, 0);
+				Release();
+				return false;
+			}
+		}
+		else GlExtensions::BindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+
+		glClear(GL_COLOR_BUFFER_BIT);
+		return true;
+	}
+
+	void StaticLayer::EndRender(){
+		GlExtensions::BindFramebuffer(GL_FRAMEBUFFER, 0);	// Back to the window (or pbuffer)
+		valid = true;
+	}
+
+	void StaticLayer::Composite() const {
+		if (texture == 0) return;
+
+		// Full screen quad in clip space.
+		glMatrixMode(GL_PROJECTION);
+		glPushMatrix();
+		glLoadIdentity();
+		glMatrixMode(GL_MODELVIEW);
+		glPushMatrix();
+		glLoadIdentity();
+
+		glEnable(GL_TEXTURE_2D);
+		glBindTexture(GL_TEXTURE_2D, texture);
+		glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE);
+		glBegin(GL_QUADS);
+		glTexCoord2f(0.0f, 0.0f); glVertex2f(-1.0f, -1.0f);
+		glTexCoord2f(1.0f, 0.0f); glVertex2f(1.0f, -1.0f);
+		glTexCoord2f(1.0f, 1.0f); glVertex2f(1.0f, 1.0f);
+		glTexCoord2f(0.0f, 1.0f); glVertex2f(-1.0f, 1.0f);
+		glEnd();
+		glBindTexture(GL_TEXTURE_2D, 0);
+		glDisable(GL_TEXTURE_2D);
+
+		glMatrixMode(GL_PROJECTION);
+		glPopMatrix();
+		glMatrixMode(GL_MODELVIEW);
+		glPopMatrix();
+	}
+
+	void StaticLayer::Release(){
+		if (framebuffer != 0 && GlExtensions::DeleteFramebuffers != NULL)
+			GlExtensions::DeleteFramebuffers(1, &framebuffer);
+		if (texture != 0) glDeleteTextures(1, &texture);
+		framebuffer = 0;
+		texture = 0;
+		valid = false;
+	}
+}
@@ -0,0 +1,77 @@
+///////////////////////////////////////////////////////////////////////////////
+/// GlFrameworkBasic is free software : you can redistribute it and or modify
+/// it under the terms of the GNU General Public License as published by
+/// the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// GlFrameworkBasic is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with GlFrameworkBasic. If not, see <http://www.gnu.org/licenses/>.
+///
+/// Author: Evan Edstrom
+/// Date: 11/17/2013
+/// Website: http://evanedstrom.com/glstart
+/// Email: contact@evanedstrom.com
+///
+///////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+#include <GL\glut.h>
+
+namespace glFrameworkBasic {
+	/**
+	* StaticLayer is an offscreen color buffer (a framebuffer object with a
+	* texture attached) the size of the viewport. Engine renders static
+	* content into it once and composites the texture as the background of
+	* every frame, instead of re-submitting that geometry each frame.
+	* Needs framebuffer object support; see IsSupported().
+	*/
+	class StaticLayer
+	{
+	public:
+		StaticLayer();
+
+		/// <summary>Destructor. Frees the GL objects if they still exist.</summary>
+		~StaticLayer();
+
+		/// <summary>True when the current context supports framebuffer objects.</summary>
+		bool IsSupported() const;
+
+		/// <summary>True when the layer holds an image of the given size.</summary>
+		bool IsValid(int width, int height) const;
+
+		/// <summary>
+		/// Redirects drawing into the layer, resizing it to width x height if
+		/// needed, and clears it with the clear color. Returns false, with
+		/// drawing still going to the window, if the layer cannot be made.
+		/// </summary>
+		bool BeginRender(int width, int height);
+
+		/// <summary>Ends BeginRender(): drawing goes back to the window and the layer is valid.</summary>
+		void EndRender();
+
+		/// <summary>Draws the layer over the whole viewport. Matrices are left unchanged.</summary>
+		void Composite() const;
+
+		/// <summary>Marks the image stale so IsValid() fails until it is rendered again.</summary>
+		void Invalidate() { valid = false; }
+
+		/// <summary>Frees the framebuffer and texture. Needs the owning context current.</summary>
+		void Release();
+
+	private:
+		GLuint framebuffer;
+		GLuint texture;
+		int width, height;
+		bool valid;
+
+		// Copy is not allowed, the GL objects are owned.
+		StaticLayer(const StaticLayer &);
+		StaticLayer &operator=(const StaticLayer &);
+	};
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Element.h"
+#include "ShapeCache.h"
 #include <iostream>
 
 namespace glFrameworkBasic {
@@ -33,19 +34,48 @@ namespace glFrameworkBasic {
 			glTranslatef(xPos, yPos, zPos);    // Translate
 			glScalef(xScale, yScale, zScale);
 
-			// Draw a Circle:
-			glBegin(GL_TRIANGLE_FAN);
+			// Draw a Circle from the cached fan, detail picked from its size on screen:
+			float scale = fabs(xScale) > fabs(yScale) ? fabs(xScale) : fabs(yScale);
+			const ShapeMesh &mesh = ShapeCache::CircleForRadius(0.5f * scale * ShapeCache::PixelsPerUnit());
 			glColor3f(0.0f, 0.0f, 1.0f);  // Blue
-			glVertex2f(0.0f, 0.0f);       // Center of circle
-			int numSegments = 100;
-			GLfloat angle;
-			for (int i = 0; i <= numSegments; i++) { // Last vertex same as first vertex
-				angle = i * 2.0f * 3.14159 / numSegments;  // 360 deg for all segments
-				glVertex2f(cos(angle) * 0.5f, sin(angle) * 0.5f);
-			}
-			glEnd();
+			glEnableClientState(GL_VERTEX_ARRAY);
+			glVertexPointer(2, GL_FLOAT, 0, mesh.xy);
+			glDrawArrays(GL_TRIANGLE_FAN, 0, mesh.count);
+			glDisableClientState(GL_VERTEX_ARRAY);
 
 			glPopMatrix();                      // Restore the model-view matrix
 		}
+
+		Aabb GetBounds() const
+		{
+			// Draw() does not rotate, and the circle has diameter 1.
+			float hx = fabs(xScale) * 0.5f, hy = fabs(yScale) * 0.5f;
+			return Aabb(xPos - hx, yPos - hy, xPos + hx, yPos + hy);
+		}
+
+		// Level of detail as the material, so sorted drawing groups circles
+		// that share a mesh into one instanced draw.
+		unsigned int GetMaterialId() const
+		{
+			float scale = fabs(xScale) > fabs(yScale) ? fabs(xScale) : fabs(yScale);
+			return (unsigned int)ShapeCache::CircleLod(0.5f * scale * ShapeCache::PixelsPerUnit());
+		}
+
+		bool Submit(RenderBatch &batch)
+		{
+			if (!show) return true;
+
+			// Same circle as Draw(), sized from the batch transform:
+			const Transform &t = batch.GetTransform();
+			float sx = sqrt(t.a * t.a + t.b * t.b), sy = sqrt(t.c * t.c + t.d * t.d);
+			float radius = 0.5f * (sx > sy ? sx : sy) * ShapeCache::PixelsPerUnit();
+			const int lod = ShapeCache::CircleLod(radius);
+
+			batch.SetColor(0.0f, 0.0f, 1.0f);  // Blue
+			if (batch.AddInstance(InstanceRenderer::CircleShape(lod))) return true;
+			const ShapeMesh &mesh = ShapeCache::Circle(lod);
+			batch.AddTriangleFan(mesh.xy, mesh.count);
+			return true;
+		}
 	};
 }
\ No newline at end of file
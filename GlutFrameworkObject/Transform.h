@@ -0,0 +1,102 @@
+///////////////////////////////////////////////////////////////////////////////
+/// GlFrameworkBasic is free software : you can redistribute it and or modify
+/// it under the terms of the GNU General Public License as published by
+/// the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// GlFrameworkBasic is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with GlFrameworkBasic. If not, see <http://www.gnu.org/licenses/>.
+///
+/// Author: Evan Edstrom
+/// Date: 11/17/2013
+/// Website: http://evanedstrom.com/glstart
+/// Email: contact@evanedstrom.com
+///
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <cmath>
+
+namespace glFrameworkBasic {
+	/**
+	* 2D affine transform with a depth value, the CPU side equivalent of the
+	* glTranslatef / glScalef / glRotatef sequence used by Element::Draw().
+	* Maps a local point to world space as:
+	*   x' = a * x + c * y + tx
+	*   y' = b * x + d * y + ty
+	*/
+	struct Transform
+	{
+		float a, b, c, d;
+		float tx, ty, z;
+
+		/// <summary>Identity transform at depth 0.</summary>
+		Transform() : a(1.0f), b(0.0f), c(0.0f), d(1.0f), tx(0.0f), ty(0.0f), z(0.0f) {}
+
+		/// <summary>
+		/// Builds translate * scale * rotate, the order Element::Draw() applies
+		/// them. Angle is in degrees about z, like glRotatef.
+		/// </summary>
+		static Transform FromTRS(float x, float y, float z, float xScale, float yScale, float angle)
+		{
+			float cs = 1.0f, sn = 0.0f;
+			if (angle != 0.0f) {	// Most elements never rotate, skip the trig.
+				const float radians = angle * 3.14159265f / 180.0f;
+				cs = cos(radians);
+				sn = sin(radians);
+			}
+			Transform t;
+			t.a = xScale * cs;	t.c = -xScale * sn;
+			t.b = yScale * sn;	t.d = yScale * cs;
+			t.tx = x; t.ty = y; t.z = z;
+			return t;
+		}
+
+		/// <summary>Returns this * child, applying child first.</summary>
+		Transform operator*(const Transform &child) const
+		{
+			Transform t;
+			t.a = a * child.a + c * child.b;
+			t.b = b * child.a + d * child.b;
+			t.c = a * child.c + c * child.d;
+			t.d = b * child.c + d * child.d;
+			t.tx = a * child.tx + c * child.ty + tx;
+			t.ty = b * child.tx + d * child.ty + ty;
+			t.z = z + child.z;
+			return t;
+		}
+
+		/// <summary>Componentwise blend, t 0 is from and 1 is to. Close to exact for small steps.</summary>
+		static Transform Lerp(const Transform &from, const Transform &to, float t)
+		{
+			Transform r;
+			r.a = from.a + (to.a - from.a) * t;
+			r.b = from.b + (to.b - from.b) * t;
+			r.c = from.c + (to.c - from.c) * t;
+			r.d = from.d + (to.d - from.d) * t;
+			r.tx = from.tx + (to.tx - from.tx) * t;
+			r.ty = from.ty + (to.ty - from.ty) * t;
+			r.z = from.z + (to.z - from.z) * t;
+			return r;
+		}
+
+		/// <summary>Column major 4x4 matrix for glMultMatrixf.</summary>
+		void ToMatrix(float m[16]) const
+		{
+			m[0] = a;	m[4] = c;	m[8] = 0.0f;	m[12] = tx;
+			m[1] = b;	m[5] = d;	m[9] = 0.0f;	m[13] = ty;
+			m[2] = 0.0f;	m[6] = 0.0f;	m[10] = 1.0f;	m[14] = z;
+			m[3] = 0.0f;	m[7] = 0.0f;	m[11] = 0.0f;	m[15] = 1.0f;
+		}
+
+		/// <summary>Transform a local x coordinate.</summary>
+		float X(float x, float y) const { return a * x + c * y + tx; }
+		/// <summary>Transform a local y coordinate.</summary>
+		float Y(float x, float y) const { return b * x + d * y + ty; }
+	};
+}